@@ -75,16 +75,22 @@ typedef struct {
     size_t count;
     size_t capacity;
   } wasm_exports;
+  struct {
+    const char **items;
+    size_t count;
+    size_t capacity;
+  } cflags;
   uint8_t flags;
 } Unit;
 
-#define unit_clear(u) do { (u)->count = 0; (u)->output_path = NULL; (u)->flags = 0; } while (0)
+#define unit_clear(u) do { (u)->count = 0; (u)->output_path = NULL; (u)->flags = 0; (u)->cflags.count = 0; } while (0)
 #define unit_input(u, input) da_append(u, input)
 #define unit_output(u, output)  (u)->output_path = (output);
 #define unit_outputf(u, ...)    (u)->output_path = temp_sprintf(__VA_ARGS__)
 #define unit_force_build(u)     (u)->flags |= UNIT_FLAG_FORCE_BUILD;
 #define unit_debug_info(u)      (u)->flags |= UNIT_FLAG_DEBUG_INFO;
 
+#define unit_cflag(u, ...)       da_append_many(&(u)->cflags, ((const char*[]){__VA_ARGS__}), (sizeof((const char*[]){__VA_ARGS__})/sizeof(const char*)))
 #define unit_wasm_export(u, fn_name) da_append(&(u)->wasm_exports, temp_sprintf("-Wl,--export=%s", fn_name))
 
 #define unit_target_browser(u)       (u)->target = UNIT_TARGET_BROWSER;
@@ -94,11 +100,14 @@ typedef struct {
 for (ssize_t ___save_space = (ssize_t)nob_temp_save(); ___save_space != -1; (nob_temp_rewind((size_t)___save_space), ___save_space = -1))
 
 void usage(const char *program) {
-  printf("Usage: %s [run|build|docs]\n", program);
+  printf("Usage: %s [run|build|aot|docs|playground-check]\n", program);
   printf("    run [(input).ql]      ---        Execute interpreter after compiling with an input file\n");
+  printf("    aot (input).ql        ---        Translate a program to C and compile it into "BUILD_FOLDER"/(input)\n");
   printf("    build                 ---        Force building of program\n");
   printf("    -etags                ---        Run etags on the C codebase\n");
   printf("    docs                  ---        Generate documentation\n");
+  printf("    builtin-hash          ---        Search the hash of the builtin words again and write it into qleei.h\n");
+  printf("    playground-check      ---        Run the examples through the playground under node and compare them with run\n");
 }
 
 /**
@@ -109,7 +118,7 @@ void usage(const char *program) {
  * command, runs the compiler, logs the outcome, and clears the unit's state before returning.
  *
  * @param cmd Command builder and executor used to assemble and run the compiler invocation.
- * @param u Unit to build (provides inputs, target, flags, wasm export list, and output path).
+ * @param u Unit to build (provides inputs, target, flags, extra compiler flags, wasm export list, and output path).
  * @returns `true` if the unit is up to date or was built successfully, `false` if the build failed
  *          or the unit could not be built (for example, if it contains only header inputs).
  */
@@ -118,7 +127,7 @@ bool build_unit(Cmd *cmd, Unit *u) {
   if (u->flags & UNIT_FLAG_FORCE_BUILD || needs_rebuild(u->output_path, u->items, u->count)) {
     cmd_append(cmd, "clang");
     if (u->target == UNIT_TARGET_BROWSER) {
-      cmd_append(cmd, "--target=wasm32-unknown-none", "-nostdlib", "-fno-builtin", "-Wl,--allow-undefined", "-Wl,--no-entry", "-Wl,--strip-all");
+      cmd_append(cmd, "--target=wasm32-unknown-none", "-msimd128", "-nostdlib", "-fno-builtin", "-Wl,--allow-undefined", "-Wl,--no-entry", "-Wl,--strip-all");
       cmd_append(cmd, "-Wl,--export=__heap_base", "-Wl,--export=__heap_end", "-Wl,--export=__indirect_function_table");
       for (size_t i = 0; i < u->wasm_exports.count; ++i) {
 	      cmd_append(cmd, u->wasm_exports.items[i]);
@@ -127,6 +136,7 @@ bool build_unit(Cmd *cmd, Unit *u) {
       cmd_append(cmd, "-m32");
     }
     cmd_append(cmd, "-Wall", "-Wextra");
+    da_foreach(const char *, cflag, &u->cflags) cmd_append(cmd, *cflag);
 
     if (u->flags & UNIT_FLAG_DEBUG_INFO) cmd_append(cmd, "-ggdb");
 
@@ -214,6 +224,39 @@ defer:
 }
 
 
+/**
+ * Translate a Qleei program to C with the native interpreter and compile it into a standalone executable.
+ *
+ * The generated C file and the executable are placed in BUILD_FOLDER, named after the input file. The executable is
+ * qleei.m32.c built with QLEEI_AOT so it registers the same custom words as the interpreter.
+ *
+ * @param cmd Command builder and executor used to run the translator and the compiler.
+ * @param unit Unit used to build the executable.
+ * @param native_output Path of the native interpreter used to translate the program.
+ * @param input_path Path of the `.ql` program to translate.
+ * @returns `true` if the executable is up to date or was built successfully, `false` otherwise.
+ */
+bool build_aot(Cmd *cmd, Unit *unit, const char *native_output, const char *input_path) {
+  String_View name = sv_from_cstr(path_name(input_path));
+  name.count -= strlen(".ql");
+  const char *output_path = temp_sprintf(BUILD_FOLDER"/"SV_Fmt, SV_Arg(name));
+  const char *c_output_path = temp_sprintf("%s.c", output_path);
+
+  if (needs_rebuild(c_output_path, ((const char*[]){ input_path, native_output }), 2)) {
+    cmd_append(cmd, native_output, input_path, "--emit-c", c_output_path);
+    if (!cmd_run(cmd)) return false;
+  }
+
+  unit_target_desktop(unit);
+  unit_output(unit, output_path);
+  unit_input(unit, "./qleei.m32.c");
+  unit_input(unit, "./qleei.h");
+  unit_input(unit, c_output_path);
+  unit_cflag(unit, "-O2", "-DQLEEI_AOT", "-I.");
+  return build_unit(cmd, unit);
+}
+
+
 bool build_docs(Cmd *cmd, Unit *unit) {
   const char *doc_gen_output = BUILD_FOLDER"/doc_gen";
   within_temp {
@@ -232,11 +275,37 @@ bool build_docs(Cmd *cmd, Unit *unit) {
   return true;
 }
 
+/**
+ * Build tools/builtin_hash.c and run it on qleei.h.
+ *
+ * The tool checks that the perfect hash qleei.h looks builtin words up with still sends each of them to its own slot,
+ * or searches the first seed that does and writes it into qleei.h along with its table.
+ *
+ * @param cmd Command builder and executor used to build and run the tool.
+ * @param unit Unit used to build the tool.
+ * @param write `true` to write the seed and table again, `false` to only check them.
+ * @returns `true` if the table is up to date or was written, `false` otherwise.
+ */
+bool build_builtin_hash(Cmd *cmd, Unit *unit, bool write) {
+  const char *builtin_hash_output = BUILD_FOLDER"/builtin_hash";
+  within_temp {
+    unit_target_desktop(unit);
+    unit_output(unit, builtin_hash_output);
+    unit_input(unit, "./tools/builtin_hash.c");
+    unit_input(unit, "./qleei.h");
+    unit_input(unit, "./nob.h");
+    if (!build_unit(cmd, unit)) return false;
+  }
+
+  cmd_append(cmd, builtin_hash_output, write ? "write" : "check");
+  return cmd_run(cmd);
+}
+
 
 /**
  * Program entry point that builds desktop and WebAssembly targets, updates TAGS when requested, and optionally runs the built native executable against a single input or all examples.
  *
- * The function parses command-line arguments ("run", "build", "-etags", "all"), invokes etags generation, builds the native and wasm outputs (with configurable debug/force flags and wasm exports), optionally copies the wasm output to ./playground, and runs the native binary either for a single .ql file or for every .ql file in ./examples while collecting per-file results.
+ * The function parses command-line arguments ("run", "build", "aot", "-etags", "all", "builtin-hash", "playground-check"), invokes etags generation, checks or rewrites the builtin word hash of qleei.h, builds the native and wasm outputs (with configurable debug/force flags and wasm exports), optionally copies the wasm output to ./playground, optionally runs the examples through the playground under node, optionally translates a .ql file to C and compiles it ahead of time, and runs the native binary either for a single .ql file or for every .ql file in ./examples while collecting per-file results.
  *
  * @returns `0` on success, non-zero on failure.
  */
@@ -248,10 +317,13 @@ int main(int argc, char **argv) {
 
   bool run_requested = false;
   bool docs_requested = false;
+  bool builtin_hash_requested = false;
+  bool playground_check_requested = false;
   bool build_demanded = false;
   bool etags_requested = false;
   bool run_all = false;
   const char *run_input_file = NULL;
+  const char *aot_input_file = NULL;
 
   while (argc > 0) {
     const char *arg = shift(argv, argc);
@@ -269,6 +341,16 @@ int main(int argc, char **argv) {
       continue;
     }
 
+    if (streq(arg, "aot")) {
+      if (argc == 0 || !sv_end_with(sv_from_cstr(*argv), ".ql")) {
+        nob_log(ERROR, "aot expects a .ql input file");
+        usage(program_name);
+        return 1;
+      }
+      aot_input_file = shift(argv, argc);
+      continue;
+    }
+
     if (streq(arg, "build")) {
       build_demanded = true;
       continue;
@@ -284,6 +366,16 @@ int main(int argc, char **argv) {
       continue;
     }
 
+    if (streq(arg, "builtin-hash")) {
+      builtin_hash_requested = true;
+      continue;
+    }
+
+    if (streq(arg, "playground-check")) {
+      playground_check_requested = true;
+      continue;
+    }
+
     nob_log(ERROR, "Unknown argument provided to build system: %s", arg);
     usage(program_name);
     return 1;
@@ -299,6 +391,10 @@ int main(int argc, char **argv) {
     return 0;
   }
 
+  // Checked once per build instead of every time a program is compiled
+  if (!build_builtin_hash(&cmd, &unit, builtin_hash_requested)) return 1;
+  if (builtin_hash_requested) return 0;
+
   const char *native_output = BUILD_FOLDER"/qleei";
 
 
@@ -326,7 +422,23 @@ int main(int argc, char **argv) {
     unit_wasm_export(&unit, "qleei_alloc_new_interpreter");
     unit_wasm_export(&unit, "qleei_interpreter_step");
     unit_wasm_export(&unit, "qleei_interpreter_lexer_init");
+    unit_wasm_export(&unit, "qleei_interpreter_exec");
     unit_wasm_export(&unit, "qleei_interpreter_free");
+    // Export documents, which the playground edits and runs again without compiling all of it
+    unit_wasm_export(&unit, "qleei_document_new");
+    unit_wasm_export(&unit, "qleei_document_edit");
+    unit_wasm_export(&unit, "qleei_document_free");
+    // Export program translation, the last four are imported by the translated modules
+    unit_wasm_export(&unit, "qleei_wasm_program_new");
+    unit_wasm_export(&unit, "qleei_wasm_program_from_document");
+    unit_wasm_export(&unit, "qleei_wasm_program_module");
+    unit_wasm_export(&unit, "qleei_wasm_program_module_size");
+    unit_wasm_export(&unit, "qleei_wasm_program_interpreter");
+    unit_wasm_export(&unit, "qleei_wasm_program_free");
+    unit_wasm_export(&unit, "qleei_wasm_program_execute_op");
+    unit_wasm_export(&unit, "qleei_wasm_program_check_call");
+    unit_wasm_export(&unit, "qleei_wasm_program_call_too_deep");
+    unit_wasm_export(&unit, "qleei_wasm_program_call");
     if (build_demanded) unit_force_build(&unit);
     if (!build_unit(&cmd, &unit)) return 1;
 
@@ -339,6 +451,15 @@ int main(int argc, char **argv) {
       }
       sb_free(sb);
     }
+
+    if (playground_check_requested) {
+      cmd_append(&cmd, "node", "./tools/playground_check.mjs", native_output, output_path);
+      if (!cmd_run(&cmd)) return 1;
+    }
+  }
+
+  if (aot_input_file) within_temp {
+    if (!build_aot(&cmd, &unit, native_output, aot_input_file)) return 1;
   }
 
   if (run_requested) {
@@ -42,7 +42,7 @@ function setup_loading_screen() {
 /**
  * Render a code editor and log panel into the given container, wire form controls and logging, persist code to localStorage, and connect the provided interpreter for execution and output handling.
  *
- * Sets up the UI (textarea, submit button, Logs section), initializes the textarea from localStorage (key "qleei:code") or example_code, and stores updates back to localStorage. Submits run the interpreter via its exec(code) method and append status or error messages to the log. Also configures interpreter.set_output({ write }) to append streamed output into the log buffer and re-render the log view. Finally, runs the initial code once on setup.
+ * Sets up the UI (textarea, submit button, Logs section), initializes the textarea from localStorage (key "qleei:code") or example_code, and stores updates back to localStorage. Submits run the interpreter via its exec(code) method, which only compiles again what changed since the previous submit, and append status or error messages to the log. Also configures interpreter.set_output({ write }) to append streamed output into the log buffer and re-render the log view. Finally, runs the initial code once on setup.
  *
  * @param {HTMLElement} div - Container element where the editor and logs are mounted.
  * @param {{ exec: (code: string) => Promise<any>, set_output: (sink: { write: (chunk: string) => void }) => void }} interpreter - Interpreter instance providing `exec(code)` to run code and `set_output` accepting a sink with a `write(content)` method to receive output chunks.
@@ -117,6 +117,8 @@ const Utf8 = Object.freeze({
 
 const mem = {
   blocks: new Map(),
+  free_blocks: new Map(), // Freed pointers by block size, reused before bumping the index
+  program_blocks: new Set(), // Blocks the running program allocated with `mem_alloc` and hasn't freed yet
   get BYTE_ALIGNMENT() { return 8; },
   align_up: (x, alignment = mem.BYTE_ALIGNMENT) => ((x + (alignment - 1)) & ~(alignment - 1)),
 
@@ -147,19 +149,45 @@ const mem = {
   // |
   // -----------------------------------------
 
-  free(ptr) { // We are using a bump allocator so we don't really implement free
+  free(ptr) { // Blocks are kept for later allocations of the same size, documents live across runs
+    const size = mem.blocks.get(ptr);
+    if (size === undefined) return;
     mem.blocks.delete(ptr);
+    mem.program_blocks.delete(ptr);
+    const list = mem.free_blocks.get(size);
+    if (list) list.push(ptr);
+    else mem.free_blocks.set(size, [ptr]);
   },
 
 
   reset() {
     mem.blocks.clear();
+    mem.free_blocks.clear();
+    mem.program_blocks.clear();
     mem.index = mem.heap_base;
   },
 
+  alloc_program(bytes_count) {
+    const ptr = mem.alloc(bytes_count);
+    if (ptr != 0) mem.program_blocks.add(ptr);
+    return ptr;
+  },
+
+  // The document's own buffers outlive the run, only what the program allocated goes back
+  free_program() {
+    for (const ptr of mem.program_blocks) mem.free(ptr);
+  },
+
   alloc(bytes_count) {
     bytes_count = mem.align_up(bytes_count);
 
+    const list = mem.free_blocks.get(bytes_count);
+    if (list && list.length > 0) {
+      const ptr = list.pop();
+      this.blocks.set(ptr, bytes_count);
+      return ptr;
+    }
+
     if (!mem.ensure_space(bytes_count)) return 0;
     const ptr = this.index;
     this.index += bytes_count;
@@ -174,18 +202,17 @@ const mem = {
     if (!this.blocks.has(base_ptr)) {
       throw new Error('[WASM] Illegal Memory Access: Attempting to reallocate a pointer that was not formally allocated before');
     }
-    if (!mem.ensure_space(bytes_count)) return 0;
+    if (this.blocks.get(base_ptr) >= bytes_count) return base_ptr;
 
-    const ptr = this.index;
-    this.index += bytes_count;
+    const ptr = this.alloc(bytes_count);
+    if (ptr == 0) return 0;
 
     const old_block = new Uint8Array(this.memory.buffer, base_ptr, this.blocks.get(base_ptr));
     const new_block = new Uint8Array(this.memory.buffer, ptr, bytes_count);
     for (let i = 0; i < Math.min(old_block.length, new_block.length); ++i) {
       new_block[i] = old_block[i];
     }
-    this.blocks.delete(base_ptr);
-    this.blocks.set(ptr, bytes_count);
+    this.free(base_ptr);
 
     return ptr;
   },
@@ -325,14 +352,6 @@ const Proc_Shape = (name) => [name, [
 ]];
 
 const env = {
-  qleei_wasm_parse_number(buf_ptr, buf_sz) {
-    if (buf_ptr == 0) {
-      throw new Error('Invalid pointer used for float parse request');
-    }
-    const str = mem.read_str(buf_ptr, buf_sz).str;
-    return parseFloat(str);
-  },
-
   qleei_wasm_malloc(sz) {
     return mem.alloc(sz);
   },
@@ -345,6 +364,10 @@ const env = {
     return mem.realloc(ptr, sz);
   },
 
+  qleei_wasm_program_malloc(sz) {
+    return mem.alloc_program(sz);
+  },
+
   qleei_wasm_printf(pFmt, pVargs) {
     const view = mem.create_view(pVargs);
 
@@ -471,10 +494,12 @@ const wait_frame = () => new Promise((resolve) => setTimeout(resolve, 0));
  *
  * @returns {{ exec: function(string): boolean, set_output: function(object|null): void }} An object with:
  *  - `exec(code)`: executes the provided source code in the interpreter and returns `true` on success, `false` otherwise.
+ *    Builds exporting documents keep the code between calls and only compile again the procedures an edit touched.
  *  - `set_output(target)`: sets the output target to an object with a `write` function or `null` to disable redirection.
  *
  * @throws {Error} If allocation of the interpreter code buffer fails.
- * @throws {Error} If a code string exceeds the transfer buffer capacity.
+ * @throws {Error} If a code string exceeds the transfer buffer capacity, when documents aren't available.
+ * @throws {Error} If the document can't be allocated or edited.
  * @throws {TypeError} If `set_output` is called with a non-object or an object lacking a `write` function.
  */
 export async function load_interpreter() {
@@ -505,8 +530,119 @@ export async function load_interpreter() {
   }
   mod.interpret_buffer = (input_path_ptr, buf_ptr, buf_len) => mod.qleei_interpret_buffer(input_path_ptr, buf_ptr, buf_len) == 1;
 
+  // Programs get translated to their own module sharing the interpreter's memory, older builds only interpret them
+  const program_env = {
+    ...env,
+    memory: exports.memory,
+    qleei_wasm_program_execute_op: exports.qleei_wasm_program_execute_op,
+    qleei_wasm_program_check_call: exports.qleei_wasm_program_check_call,
+    qleei_wasm_program_call_too_deep: exports.qleei_wasm_program_call_too_deep,
+    qleei_wasm_program_call: exports.qleei_wasm_program_call,
+  };
+  const can_compile_programs = typeof mod.qleei_wasm_program_new === 'function';
+
+  /**
+   * Run a translated program and free it along with the memory it allocated and didn't free, calling `interpret`
+   * instead if its module can't be instantiated.
+   *
+   * @returns {Promise<boolean>} `true` if the program ran to completion, `false` otherwise.
+   */
+  const run_program = async (program, interpret) => {
+    try {
+      let instance;
+      try {
+        const ptr  = mod.qleei_wasm_program_module(program);
+        const size = mod.qleei_wasm_program_module_size(program);
+        const bytes = new Uint8Array(mem.buffer, ptr, size).slice();
+        ({ instance } = await WebAssembly.instantiate(bytes, { env: program_env }));
+      } catch (e) {
+        console.warn('[WASM] Could not instantiate the program module, interpreting it instead', e);
+        return interpret();
+      }
+      return instance.exports.main(mod.qleei_wasm_program_interpreter(program)) == 1;
+    } finally {
+      mod.qleei_wasm_program_free(program);
+      mem.free_program();
+    }
+  };
+
+  /**
+   * Translate the program to a WebAssembly module and run it, falling back to the interpreter if the module can't be instantiated.
+   *
+   * @returns {Promise<boolean>} `true` if the program ran to completion, `false` otherwise.
+   */
+  mod.run_buffer = async (input_path_ptr, buf_ptr, buf_len) => {
+    if (!can_compile_programs) return mod.interpret_buffer(input_path_ptr, buf_ptr, buf_len);
+
+    const program = mod.qleei_wasm_program_new(input_path_ptr, buf_ptr, buf_len);
+    if (program == 0) return false; // Compilation errors were already printed
+
+    return run_program(program, () => mod.interpret_buffer(input_path_ptr, buf_ptr, buf_len));
+  };
+
+  // Documents keep their tokens and procedures between runs, older builds copy and compile all the code every time
+  const can_edit_documents = can_compile_programs && typeof mod.qleei_document_new === 'function';
+  let document = 0;
+  let document_bytes = new Uint8Array(0);
+
+  /**
+   * Replace the bytes of the document that differ from `bytes`, as a single edit spanning the changed middle.
+   */
+  const edit_document = (bytes) => {
+    if (document == 0) {
+      const input_path_ptr = mem.alloc_js_str_as_zstr('input.ql');
+      document = mod.qleei_document_new(input_path_ptr);
+      mem.free(input_path_ptr);
+      if (document == 0) {
+        throw new Error('Failed to allocate the document');
+      }
+    }
+
+    const old = document_bytes;
+    const shortest = Math.min(old.byteLength, bytes.byteLength);
+    let prefix = 0;
+    while (prefix < shortest && old[prefix] == bytes[prefix]) ++prefix;
+    let suffix = 0;
+    while (suffix < shortest - prefix && old[old.byteLength - 1 - suffix] == bytes[bytes.byteLength - 1 - suffix]) ++suffix;
+
+    const removed = old.byteLength - prefix - suffix;
+    const text = bytes.subarray(prefix, bytes.byteLength - suffix);
+    if (removed == 0 && text.byteLength == 0) return;
+
+    let text_ptr = 0;
+    if (text.byteLength > 0) {
+      text_ptr = mem.alloc(text.byteLength);
+      if (text_ptr == 0) {
+        throw new Error('Failed to allocate ' + text.byteLength.toString(10) + ' bytes for the edited code');
+      }
+      new Uint8Array(mem.buffer, text_ptr, text.byteLength).set(text);
+    }
+    const edited = mod.qleei_document_edit(document, prefix, removed, text_ptr, text.byteLength) == 1;
+    mem.free(text_ptr);
+    if (!edited) {
+      throw new Error('Failed to edit the document');
+    }
+    document_bytes = bytes;
+  };
+
+  /**
+   * Edit the document into `code`, compile what changed and run it like `run_buffer`.
+   *
+   * @returns {Promise<boolean>} `true` if the program ran to completion, `false` otherwise.
+   */
+  mod.run_document = async (code) => {
+    edit_document(Utf8.encode(code));
+
+    const program = mod.qleei_wasm_program_from_document(document);
+    if (program == 0) return false; // Compilation errors were already printed
+
+    return run_program(program, () => mod.qleei_interpreter_exec(mod.qleei_wasm_program_interpreter(program)) == 1);
+  };
+
 
   const interpret_code = async (code) => {
+    if (can_edit_documents) return mod.run_document(code);
+
     mem.reset();
 
     const CODE_BUF_CAP = mem.align_up(1024*8);
@@ -529,7 +665,7 @@ export async function load_interpreter() {
     }
     view[bytes.byteLength] = 0;
 
-    return mod.interpret_buffer(input_path_ptr, buf.ptr, buf.len);
+    return mod.run_buffer(input_path_ptr, buf.ptr, buf.len);
   };
 
   return {
@@ -123,10 +123,13 @@ bool qleei_zstr_eq(const char *za, const char *zb);
 char *qleei_zstr_dup(const char *zstr);
 
 /**
- * Parse a floating-point number from a string view.
+ * Parse a floating-point number from a string view without copying it.
+ *
+ * Accepts an optional sign, decimal digits with an optional fraction and an optional `e` exponent, and ignores what
+ * follows them. The result is the correctly rounded `double` on every platform.
  *
  * @param sv String view containing the numeric literal to parse.
- * @returns The parsed `double` value; if `sv` does not contain a valid numeric literal, returns `0.0`.
+ * @returns The parsed `double` value; if `sv` does not start with a valid numeric literal, returns `0.0`.
  */
 double qleei_parse_number(Qleei_String_View sv);
 
@@ -233,6 +236,16 @@ void *qleei_mem_realloc (void *ptr, qleei_uisz_t size);
  * @param ptr Pointer to the block to free. If `ptr` is NULL no action is taken.
  */
 void  qleei_mem_free    (void *ptr);
+/**
+ * Allocate a block of memory for the program being run, used by `mem_alloc`. It is freed with qleei_mem_free.
+ *
+ * Browser builds let the host keep track of these blocks, so it can free the ones the program leaves behind once
+ * it ran.
+ *
+ * @param size Number of bytes to allocate.
+ * @returns Pointer to the allocated memory, or `NULL` if allocation failed.
+ */
+void *qleei_program_mem_alloc(qleei_uisz_t size);
 /**
  * Copy `count` bytes from `src` to `dest`.
  *
@@ -286,17 +299,46 @@ static inline bool qleei_is_identifier_char(char c);
 
 
 /**
- * A source location within a file, used for error reporting.
+ * Starts of the lines of the last buffer a location was resolved in, recorded as far as the locations went.
+ */
+typedef struct {
+  const char   *buffer;
+  qleei_uisz_t  scanned; // Bytes of `buffer` already searched for newlines
+  qleei_uisz_t *items;   // Index of the first byte of every line found so far
+  qleei_uisz_t  len;
+  qleei_uisz_t  cap;
+} Qleei_Line_Starts;
+
+/**
+ * A source location within a file, used for error reporting. Its line and column are only worked out when reported.
  */
 typedef struct {
   const char *file_path;
-  qleei_uisz_t index;
-  qleei_uisz_t line;
-  qleei_uisz_t column;
+  const char *buffer;       // Source the location points into, NULL if unknown
+  qleei_uisz_t index;       // Byte offset into `buffer`
+  qleei_uisz_t line_base;   // Lines of the input that came before `buffer`
+  Qleei_Line_Starts *lines; // Table the line is looked up in, NULL to count the lines from the start of `buffer`
 } QLeei_Lex_Location;
 
+/**
+ * Compute the line and column of a location, both starting at 1.
+ *
+ * A location with a table of line starts records the starts of the lines of its buffer up to the location, locations
+ * resolved after it are found with a binary search over them. Columns count bytes.
+ *
+ * @param loc Location to resolve.
+ * @param line Receives the line, 0 if the location has no buffer.
+ * @param column Receives the column, 0 if the location has no buffer.
+ */
+void qleei_loc_line_column(QLeei_Lex_Location loc, qleei_uisz_t *line, qleei_uisz_t *column);
+
 #define qleei_loc_printfn(loc, ...) \
-do { qleei_printf("%s:%zu:%zu: ", (loc).file_path, (loc).line, (loc).column); qleei_printfn(__VA_ARGS__); } while (0)
+do { \
+  qleei_uisz_t qleei__line, qleei__column; \
+  qleei_loc_line_column((loc), &qleei__line, &qleei__column); \
+  qleei_printf("%s:%zu:%zu: ", (loc).file_path, qleei__line, qleei__column); \
+  qleei_printfn(__VA_ARGS__); \
+} while (0)
 
 /**
  * The kind of a token produced by the lexer.
@@ -319,10 +361,104 @@ typedef struct {
 
   Qleei_String_View string;
   double number;
+  qleei_ui8_t symbol; // Byte of a one byte symbol, 0 for longer ones like '->'
+  qleei_ui32_t id;    // Interned identifier, see Qleei_Symbols; QLEEI_SYMBOL_NONE for other tokens
 } QLeei_Token;
 
 const char *qleei_get_token_kind_name(Qleei_Token_Kind kind);
 
+/**
+ * The tokens of a whole buffer stored as parallel arrays, the `i`-th entry of every array describes the `i`-th token.
+ */
+typedef struct {
+  qleei_ui8_t  *kinds;   // Qleei_Token_Kind of each token
+  qleei_ui32_t *offsets; // Index in the buffer of the first byte of each token
+  qleei_ui32_t *lengths; // Length in bytes of each token
+  double       *numbers; // Value of the number and bool tokens, 0 for the others
+  qleei_ui32_t *ids;     // Symbol id of the identifier tokens, QLEEI_SYMBOL_NONE for the others
+  qleei_uisz_t  len;
+  qleei_uisz_t  cap;
+} Qleei_Tokens;
+
+/**
+ * Ids of the identifiers the compiler looks for. Every symbol table gives them these ids, lexers without one still do.
+ */
+typedef enum {
+  QLEEI_SYMBOL_NONE = 0,
+  QLEEI_SYMBOL_WHILE,
+  QLEEI_SYMBOL_BEGIN,
+  QLEEI_SYMBOL_END,
+  QLEEI_SYMBOL_PROC,
+  QLEEI_SYMBOL_TRUE,
+  QLEEI_SYMBOL_FALSE,
+  QLEEI_SYMBOL_NUMBER,
+  QLEEI_SYMBOL_BOOL,
+  QLEEI_SYMBOL_POINTER,
+  QLEEI_SYMBOL_PTR,
+  QLEEI_SYMBOL_KEYWORD_COUNT,
+} Qleei_Symbol_Id;
+
+/**
+ * An identifier interned into a symbol table, with what it names as of the last time it was looked up.
+ */
+typedef struct {
+  qleei_uisz_t name;     // Offset of the name in `Qleei_Symbols.names`
+  qleei_uisz_t len;
+  qleei_ui32_t hash;
+  qleei_uisz_t builtin;  // Index + 1 of the builtin word with this name, 0 if there is none
+  qleei_uisz_t resolved; // `epoch` + 1 of the interpreter when `word` and `proc` were looked up, 0 if they weren't
+  qleei_uisz_t word;     // Index + 1 of the custom word with this name, 0 if there is none
+  qleei_uisz_t proc;     // Index + 1 of the procedure with this name, 0 if there is none
+} Qleei_Symbol;
+
+/**
+ * A table giving every distinct identifier a dense id, starting with the ids of `Qleei_Symbol_Id`.
+ *
+ * Names are copied into `names` so ids stay valid once the source they were lexed from is freed.
+ * `index` is a hash table of the ids using open addressing with linear probing, 0 marks free slots.
+ */
+typedef struct {
+  Qleei_Symbol *items; // Indexed by id, the entry of QLEEI_SYMBOL_NONE is unused
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+
+  struct {
+    char *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } names;
+
+  struct {
+    qleei_ui32_t *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;    // Number of slots, a power of two
+  } index;
+} Qleei_Symbols;
+
+/**
+ * Intern an identifier, giving it the next free id the first time it is seen.
+ *
+ * @param symbols Symbol table to intern into.
+ * @param name Identifier to intern, it is copied.
+ * @returns The id of `name`, or QLEEI_SYMBOL_NONE if allocation failed.
+ */
+qleei_ui32_t qleei_symbols_intern(Qleei_Symbols *symbols, Qleei_String_View name);
+
+/**
+ * Get the name of an interned identifier.
+ *
+ * @param symbols Symbol table the id comes from.
+ * @param id Id returned by qleei_symbols_intern.
+ * @returns A view of the name, valid until the next identifier is interned; empty for unknown ids.
+ */
+Qleei_String_View qleei_symbols_name(const Qleei_Symbols *symbols, qleei_ui32_t id);
+
+/**
+ * Free the memory held by a symbol table.
+ *
+ * @param symbols Symbol table to free.
+ */
+void qleei_symbols_free(Qleei_Symbols *symbols);
 
 /**
  * The lexer state for tokenizing Qleei source code.
@@ -333,8 +469,13 @@ typedef struct {
   qleei_uisz_t buffer_len;
 
   qleei_uisz_t index;
-  qleei_uisz_t line;
-  qleei_uisz_t column;
+  qleei_uisz_t line_base; // Lines of the input that came before `buffer`, for inputs lexed in parts
+
+  const Qleei_Tokens *tokens; // Tokens of `buffer` replayed instead of lexing it again, NULL to lex it
+  qleei_uisz_t cursor;        // Next entry of `tokens` to replay
+
+  Qleei_Symbols *symbols;     // Table identifiers are interned into, NULL gives only the keywords an id
+  Qleei_Line_Starts *lines;   // Table the locations of the tokens resolve their line in, may be NULL
 
   QLeei_Token token;
 } QLeei_Lexer;
@@ -354,7 +495,7 @@ void qleei_lexer_init(QLeei_Lexer *l, const char *input_path, const char *buffer
 /**
  * Advance the lexer to the next token and populate lexer->token with its kind, location, text, and numeric value when applicable.
  *
- * @param lexer Lexer state to advance; its index, line, column and token fields will be updated.
+ * @param lexer Lexer state to advance; its index and token fields will be updated.
  * @returns `true` if a token (including EOF) was successfully produced and stored in `lexer->token`, `false` on a lexing error (for example when `lexer->buffer` is NULL or an unterminated/invalid character literal is encountered).
  */
 bool qleei_lexer_next(QLeei_Lexer *lexer);
@@ -375,21 +516,54 @@ bool qleei_lexer_peek(QLeei_Lexer *l, QLeei_Token *t);
  * Capture the lexer's current location so parsing can be resumed later.
  *
  * @param l Lexer whose current position will be saved.
- * @returns A QLeei_Lex_Location containing the lexer's current file_path, index, line, and column.
+ * @returns A QLeei_Lex_Location containing the lexer's current file_path, buffer and index.
  */
 QLeei_Lex_Location qleei_lexer_save_point(QLeei_Lexer *l);
 
 /**
  * Restore the lexer's current position from a saved location.
  *
- * Sets the lexer's input_path, index, line, and column to the values in save_point.
+ * Sets the lexer's input_path and index to the values in save_point.
  *
  * @param l Lexer to restore.
- * @param save_point Saved location providing file_path, index, line, and column.
+ * @param save_point Saved location providing file_path and index.
  * @returns `true` if the lexer was restored (always `true`).
  */
 bool qleei_lexer_restore_point(QLeei_Lexer *l, QLeei_Lex_Location save_point);
 
+/**
+ * Lex a whole buffer in one pass into a token buffer.
+ *
+ * The previous contents of `tokens` are replaced, its arrays are reused when they are large enough.
+ *
+ * @param tokens Token buffer receiving every token of the input, the EOF is not stored.
+ * @param input_path Path used for error messages (may be NULL).
+ * @param buffer Input buffer to lex.
+ * @param buf_size Size of the input buffer, at most 4 GiB.
+ * @returns `true` if the whole buffer was lexed, `false` on a lexing error or if allocation failed.
+ */
+bool qleei_tokenize(Qleei_Tokens *tokens, const char *input_path, const char *buffer, qleei_uisz_t buf_size);
+
+/**
+ * Free the arrays held by a token buffer.
+ *
+ * @param tokens Token buffer to free.
+ */
+void qleei_tokens_free(Qleei_Tokens *tokens);
+
+/**
+ * Initialize a lexer that replays the tokens `qleei_tokenize` produced for `buffer` instead of lexing it.
+ *
+ * The lexer produces the same tokens and locations as one initialized with `qleei_lexer_init`.
+ *
+ * @param l Pointer to the lexer to initialize.
+ * @param input_path Human-readable source path used for location reporting (may be NULL).
+ * @param buffer Buffer the tokens were produced from.
+ * @param buf_size Length of the input buffer in bytes.
+ * @param tokens Tokens of `buffer`, they must outlive the lexer.
+ */
+void qleei_lexer_init_tokens(QLeei_Lexer *l, const char *input_path, const char *buffer, qleei_uisz_t buf_size, const Qleei_Tokens *tokens);
+
 
 /**
  * The kind of a value on the Qleei stack.
@@ -410,8 +584,31 @@ typedef enum {
 const char *qleei_get_value_kind_name(Qleei_Value_Kind kind);
 
 
+#ifdef QLEEI_NAN_BOXING
+
+#define QLEEI_NAN_BOX_TAG_SHIFT    48
+#define QLEEI_NAN_BOX_TAG_NUMBERS  0xFFFCULL               // First tag that isn't a number, a kind's tag is this plus the kind
+#define QLEEI_NAN_BOX_PAYLOAD_MASK 0x0000FFFFFFFFFFFFULL
+
+/**
+ * A value that can be stored on the Qleei stack, NaN-boxed into 8 bytes.
+ *
+ * Numbers are kept as the bits of their double. Bools and pointers are stored in negative quiet NaNs whose top
+ * 16 bits hold QLEEI_NAN_BOX_TAG_NUMBERS plus their kind and whose low 48 bits hold the value, arithmetic on the
+ * numbers the interpreter produces never yields those NaNs. Use the qleei_value_item_* accessors to read and
+ * build items, every translation unit sharing items must agree on QLEEI_NAN_BOXING.
+ */
+typedef struct {
+  qleei_ui64_t bits;
+} Qleei_Value_Item;
+
+#else
+
 /**
  * A value that can be stored on the Qleei stack. Contains a kind tag and the actual value data.
+ *
+ * Define QLEEI_NAN_BOXING to store items in 8 bytes instead, code going through the qleei_value_item_*
+ * accessors works with either representation.
  */
 typedef union {
   Qleei_Value_Kind kind;
@@ -432,6 +629,93 @@ typedef union {
   } as_bool;
 } Qleei_Value_Item;
 
+#endif // QLEEI_NAN_BOXING
+
+/**
+ * Get the kind of a value item.
+ *
+ * @param item Item to inspect.
+ * @returns The kind the item was built with.
+ */
+static inline Qleei_Value_Kind qleei_value_item_kind(Qleei_Value_Item item) {
+#ifdef QLEEI_NAN_BOXING
+  if (item.bits < (QLEEI_NAN_BOX_TAG_NUMBERS << QLEEI_NAN_BOX_TAG_SHIFT)) return QLEEI_VALUE_KIND_NUMBER;
+  return (Qleei_Value_Kind)((item.bits >> QLEEI_NAN_BOX_TAG_SHIFT) - QLEEI_NAN_BOX_TAG_NUMBERS);
+#else
+  return item.kind;
+#endif
+}
+
+/**
+ * Get the number held by an item of kind QLEEI_VALUE_KIND_NUMBER, see qleei_value_item_as_number to convert other kinds.
+ */
+static inline double qleei_value_item_number(Qleei_Value_Item item) {
+#ifdef QLEEI_NAN_BOXING
+  union { qleei_ui64_t bits; double value; } u = { .bits = item.bits };
+  return u.value;
+#else
+  return item.as_number.value;
+#endif
+}
+
+/**
+ * Get the bool held by an item of kind QLEEI_VALUE_KIND_BOOL, see qleei_value_item_as_bool to convert other kinds.
+ */
+static inline bool qleei_value_item_bool(Qleei_Value_Item item) {
+#ifdef QLEEI_NAN_BOXING
+  return (item.bits & 1) != 0;
+#else
+  return item.as_bool.value;
+#endif
+}
+
+/**
+ * Get the pointer held by an item of kind QLEEI_VALUE_KIND_POINTER.
+ */
+static inline char *qleei_value_item_pointer(Qleei_Value_Item item) {
+#ifdef QLEEI_NAN_BOXING
+  return (char*)(qleei_uisz_t)(item.bits & QLEEI_NAN_BOX_PAYLOAD_MASK);
+#else
+  return item.as_pointer.value;
+#endif
+}
+
+/**
+ * Build an item of kind QLEEI_VALUE_KIND_NUMBER.
+ */
+static inline Qleei_Value_Item qleei_value_item_from_number(double value) {
+#ifdef QLEEI_NAN_BOXING
+  union { double value; qleei_ui64_t bits; } u = { .value = value };
+  return (Qleei_Value_Item){ .bits = u.bits };
+#else
+  return (Qleei_Value_Item){ .as_number = { .kind = QLEEI_VALUE_KIND_NUMBER, .value = value } };
+#endif
+}
+
+/**
+ * Build an item of kind QLEEI_VALUE_KIND_BOOL.
+ */
+static inline Qleei_Value_Item qleei_value_item_from_bool(bool value) {
+#ifdef QLEEI_NAN_BOXING
+  return (Qleei_Value_Item){ .bits = ((QLEEI_NAN_BOX_TAG_NUMBERS + QLEEI_VALUE_KIND_BOOL) << QLEEI_NAN_BOX_TAG_SHIFT) | (value ? 1 : 0) };
+#else
+  return (Qleei_Value_Item){ .as_bool = { .kind = QLEEI_VALUE_KIND_BOOL, .value = value } };
+#endif
+}
+
+/**
+ * Build an item of kind QLEEI_VALUE_KIND_POINTER. With QLEEI_NAN_BOXING only the low 48 bits of the address
+ * are kept, which holds every user space address on the platforms the interpreter runs on.
+ */
+static inline Qleei_Value_Item qleei_value_item_from_pointer(void *value) {
+#ifdef QLEEI_NAN_BOXING
+  qleei_ui64_t address = (qleei_uisz_t)value;
+  return (Qleei_Value_Item){ .bits = ((QLEEI_NAN_BOX_TAG_NUMBERS + QLEEI_VALUE_KIND_POINTER) << QLEEI_NAN_BOX_TAG_SHIFT) | (address & QLEEI_NAN_BOX_PAYLOAD_MASK) };
+#else
+  return (Qleei_Value_Item){ .as_pointer = { .kind = QLEEI_VALUE_KIND_POINTER, .value = (char*)value } };
+#endif
+}
+
 /**
  * Append a Qleei_Value_Kind to a dynamic array, growing the array if needed.
  *
@@ -481,9 +765,128 @@ bool qleei_stack_push(Qleei_Stack *stack, Qleei_Value_Item item);
  */
 bool qleei_stack_pop(Qleei_Stack *stack, Qleei_Value_Item *item);
 
+/**
+ * The kind of an instruction produced by the compiler.
+ */
+typedef enum {
+  QLEEI_OP_NONE = 0,
+  QLEEI_OP_HALT,
+  QLEEI_OP_PUSH_NUMBER,
+  QLEEI_OP_PUSH_BOOL,
+  QLEEI_OP_ADD,
+  QLEEI_OP_SUB,
+  QLEEI_OP_MUL,
+  QLEEI_OP_DIV,
+  QLEEI_OP_ABORT,
+  QLEEI_OP_DUP,
+  QLEEI_OP_OVER,
+  QLEEI_OP_DROP,
+  QLEEI_OP_ROT2,
+  QLEEI_OP_SWAP3,
+  QLEEI_OP_ROT3,
+  QLEEI_OP_BUILTIN,
+  QLEEI_OP_DUP_PUSH_ADD,
+  QLEEI_OP_PUSH_ADD,
+  QLEEI_OP_PUSH_ROT2_SUB,
+  QLEEI_OP_PUSH_ROT2_SAVE_UI8,
+  QLEEI_OP_SQUARE,
+  QLEEI_OP_CUBE,
+  QLEEI_OP_ADD_NUMBERS,
+  QLEEI_OP_SUB_NUMBERS,
+  QLEEI_OP_MUL_NUMBERS,
+  QLEEI_OP_DIV_NUMBERS,
+  QLEEI_OP_CALL,
+  QLEEI_OP_JUMP,
+  QLEEI_OP_JUMP_UNLESS,
+  QLEEI_OP_JUMP_IF,
+  QLEEI_OP_RETURN,
+} Qleei_Op_Kind;
+
+const char *qleei_get_op_kind_name(Qleei_Op_Kind kind);
+
+/**
+ * A single bytecode instruction.
+ */
+typedef struct {
+  Qleei_Op_Kind kind;
+  qleei_uisz_t  arg;    // Jump target for control flow instructions, builtin word index for `QLEEI_OP_BUILTIN`,
+                        // length of the fused sequence for superinstructions, for `QLEEI_OP_CALL` the index + 1
+                        // of the procedure whose inputs were proven to be on the stack, 0 if they weren't
+  double        number; // Literal value for push instructions and superinstructions
+} Qleei_Op;
+
+/**
+ * What the name of a `QLEEI_OP_CALL` resolved to the last time it ran.
+ */
+typedef struct {
+  qleei_uisz_t epoch; // `epoch` of the interpreter when the name was resolved
+  qleei_uisz_t word;  // Index + 1 of the custom word the name resolved to, 0 if it isn't one
+  qleei_uisz_t proc;  // Index + 1 of the procedure the name resolved to, 0 if it isn't one
+} Qleei_Call_Cache;
+
+/**
+ * A flat array of compiled instructions.
+ *
+ * The source token of every instruction is kept in `tokens` at the same index as the instruction.
+ * They are only read when reporting errors or when calling into a word handler, so they are kept
+ * apart from the instructions themselves. `calls` is indexed the same way and only used by calls.
+ */
+typedef struct {
+  Qleei_Op *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+
+  struct {
+    QLeei_Token *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } tokens;
+
+  struct {
+    Qleei_Call_Cache *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } calls;
+} Qleei_Code;
+
+/**
+ * Append an instruction to a code buffer.
+ *
+ * @param code Code buffer to append to.
+ * @param op Instruction to append.
+ * @param token Source token the instruction was compiled from.
+ * @returns `true` if the instruction was appended, `false` if allocation failed.
+ */
+bool qleei_code_emit(Qleei_Code *code, Qleei_Op op, QLeei_Token token);
+
+/**
+ * Free the instructions and tokens held by a code buffer.
+ *
+ * @param code Code buffer to free.
+ */
+void qleei_code_free(Qleei_Code *code);
+
+// The JIT is opt-in with `-DQLEEI_ENABLE_JIT` and only available to x86-64 Linux desktop builds
+#if defined(QLEEI_ENABLE_JIT) && defined(PLATFORM_DESKTOP) && defined(__x86_64__) && defined(__linux__)
+#  define QLEEI_JIT
+#endif
+
+#ifdef QLEEI_JIT
+#  ifndef QLEEI_JIT_THRESHOLD
+#    define QLEEI_JIT_THRESHOLD 1000 // Calls after which a procedure's body is compiled to machine code
+#  endif
+/**
+ * Machine code generated for a procedure body, `inputs` points at the deepest of the procedure's inputs on the stack.
+ */
+typedef void (*Qleei_Jit_Fn)(Qleei_Value_Item *inputs);
+#endif // QLEEI_JIT
+
+#ifndef QLEEI_VERIFY_MAX_DEPTH
+#  define QLEEI_VERIFY_MAX_DEPTH 16 // Items at the top of the stack whose kinds are tracked while verifying code
+#endif
+
 typedef struct {
-  QLeei_Lex_Location body_start;
-  QLeei_Lex_Location body_end;
+  Qleei_Code body; // Compiled body, closed by a `QLEEI_OP_RETURN`
 
   Qleei_String_View name_sv;
 
@@ -498,15 +901,50 @@ typedef struct {
     qleei_uisz_t len;
     qleei_uisz_t cap;
   } outputs;
+
+  // What the body was proven to do to the stack when it returns, used to verify the code calling it
+  struct {
+    bool         known;
+    qleei_uisz_t consumes;     // Items taken from the top of the stack, inputs included
+    qleei_uisz_t produces_len;
+    qleei_ui8_t  produces[QLEEI_VERIFY_MAX_DEPTH]; // Kinds of the items left in their place, the last one on top
+  } effect;
+
+  // Tokens the definition was compiled from, `proc` to the closing `end`, when the lexer replayed a token buffer
+  struct {
+    qleei_uisz_t first;
+    qleei_uisz_t end;    // One past the closing `end`, 0 when the lexer didn't replay tokens
+    qleei_uisz_t offset; // Index in the buffer of the `proc` token
+    qleei_ui32_t name;   // Symbol id of the name
+  } source;
+
+#ifdef QLEEI_JIT
+  struct {
+    Qleei_Jit_Fn fn;      // NULL until the procedure got hot and its body could be compiled
+    qleei_uisz_t size;    // Size of the executable mapping behind `fn`
+    qleei_uisz_t outputs; // Number of items `fn` leaves in place of the inputs
+    qleei_uisz_t calls;
+    bool         failed;  // The body uses something the JIT doesn't support, it stays interpreted
+  } jit;
+#endif // QLEEI_JIT
 } Qleei_Proc;
 
 /**
  * A dynamic array of user-defined procedures.
+ *
+ * `index` is a hash table of the procedures by name, using open addressing with linear probing.
+ * It holds indices into `items` so it stays valid when `items` is reallocated.
  */
 typedef struct {
   Qleei_Proc *items;
   qleei_uisz_t len;
   qleei_uisz_t cap;
+
+  struct {
+    qleei_uisz_t *items; // Index + 1 of the procedure in each slot, 0 for free slots
+    qleei_uisz_t len;
+    qleei_uisz_t cap;    // Number of slots, a power of two
+  } index;
 } Qleei_Procs;
 
 /**
@@ -518,6 +956,34 @@ typedef struct {
  */
 Qleei_Proc *qleei_procs_find_by_sv_name(Qleei_Procs *haystack, Qleei_String_View needle);
 
+/**
+ * Append a procedure to a list of procedures.
+ *
+ * A procedure named like one already in the list is kept, but lookups keep finding the first one.
+ *
+ * @param procs List of procedures to append to.
+ * @param proc Procedure to append, the list takes ownership of its body and type lists.
+ * @returns `true` if the procedure was appended, `false` if allocation failed.
+ */
+bool qleei_procs_append(Qleei_Procs *procs, Qleei_Proc proc);
+
+/**
+ * Free the list of procedures and its index, not the procedures themselves.
+ *
+ * @param procs List of procedures to free.
+ */
+void qleei_procs_free(Qleei_Procs *procs);
+
+/**
+ * Check that the stack holds the inputs declared by `proc` before calling it, reporting an error if it doesn't.
+ *
+ * @param proc Procedure about to be called.
+ * @param stack Stack the procedure is going to consume its inputs from.
+ * @param token Token of the call, used for error reporting.
+ * @returns `true` if the procedure can be called, `false` otherwise.
+ */
+bool qleei_proc_check_inputs(Qleei_Proc *proc, Qleei_Stack *stack, QLeei_Token token);
+
 /**
  * Options passed to custom word handlers, containing the interpreter state.
  */
@@ -534,24 +1000,58 @@ typedef struct {
  */
 typedef bool (*Qleei_Word_Handler)(Qleei_Word_Handler_Opt opt);
 
+#ifndef QLEEI_WORD_MAX_ITEMS
+#  define QLEEI_WORD_MAX_ITEMS 8 // Inputs or outputs a word with a signature can have
+#endif
+
+/**
+ * Kinds of the items a word consumes from the stack and of the ones it leaves in their place.
+ */
+typedef struct {
+  qleei_uisz_t     inputs_len;
+  Qleei_Value_Kind inputs[QLEEI_WORD_MAX_ITEMS];  // The last one is the top of the stack
+  qleei_uisz_t     outputs_len;
+  Qleei_Value_Kind outputs[QLEEI_WORD_MAX_ITEMS]; // The last one ends up on top of the stack
+} Qleei_Word_Signature;
+
+/**
+ * Context passed to fast word handlers.
+ */
+typedef struct {
+  void *user_data;          // Data given when registering the word, the interpreter if there was none
+  const QLeei_Token *token; // Token of the call, used for error reporting
+} Qleei_Word_Context;
+
+/**
+ * Function pointer type for custom word handlers registered with a signature.
+ *
+ * `slots` points to the stack items holding the inputs, in the order of the signature, which the
+ * interpreter already checked. The handler stores its outputs in the same slots, there is room for
+ * them even when there are more outputs than inputs. Outputs are built with the qleei_value_item_from_*
+ * constructors, without QLEEI_NAN_BOXING their kinds are also set from the signature.
+ */
+typedef bool (*Qleei_Fast_Word_Handler)(const Qleei_Word_Context *ctx, Qleei_Value_Item *slots);
+
 /**
  * A key-value pair mapping a word name to its handler and user data.
  */
 typedef struct {
   const char *key;
   struct {
-    Qleei_Word_Handler handler;
+    Qleei_Word_Handler handler;                // NULL for words registered with a signature
+    Qleei_Fast_Word_Handler fast;              // Only set for words registered with a signature
+    const Qleei_Word_Signature *signature;     // Owned by the caller, like `key`
     void *user_data;
   } val;
 } Qleei_Custom_Word;
 
 /**
- * A dynamic array of custom word entries.
+ * A hash map of custom words keyed on their name, using open addressing with linear probing.
  */
 typedef struct {
-  Qleei_Custom_Word *items;
-  qleei_uisz_t len;
-  qleei_uisz_t cap;
+  Qleei_Custom_Word *items; // Slots of the map, free ones have a NULL `key`
+  qleei_uisz_t len;         // Number of words in the map
+  qleei_uisz_t cap;         // Number of slots, a power of two
 } Qleei_Custom_Words;
 
 /**
@@ -565,6 +1065,18 @@ typedef struct {
  */
 bool qleei_custom_words_add(Qleei_Custom_Words *w, const char *word, Qleei_Word_Handler handler, void *user_data);
 
+/**
+ * Add or update a word with a signature in the custom words registry.
+ *
+ * @param w Registry to insert into or update.
+ * @param word Null-terminated word name (must not be a builtin).
+ * @param handler Function to invoke when the word is encountered.
+ * @param signature Kinds the word consumes and produces, must outlive the registration.
+ * @param user_data Arbitrary pointer forwarded to the handler; may be NULL.
+ * @returns `true` on success, `false` if allocation failed, an argument is NULL or the signature has too many items.
+ */
+bool qleei_custom_words_add_fast(Qleei_Custom_Words *w, const char *word, Qleei_Fast_Word_Handler handler, const Qleei_Word_Signature *signature, void *user_data);
+
 /**
  * Remove a word from the custom words registry.
  *
@@ -574,14 +1086,60 @@ bool qleei_custom_words_add(Qleei_Custom_Words *w, const char *word, Qleei_Word_
  */
 bool qleei_custom_words_remove(Qleei_Custom_Words *w, const char *word);
 
+#ifndef QLEEI_MAX_CALL_DEPTH
+#  define QLEEI_MAX_CALL_DEPTH 65536 // Procedure calls that can be nested before execution fails
+#endif
+
+/**
+ * Where execution continues once the procedure being executed returns.
+ */
+typedef struct {
+  Qleei_Code  *code;
+  qleei_uisz_t pc;
+  bool         inside_of_proc;
+} Qleei_Frame;
+
+/**
+ * A dynamic array of call frames, the last one belongs to the innermost call.
+ */
+typedef struct {
+  Qleei_Frame *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei_Frames;
+
+/**
+ * A dynamic array of source buffers owned by the interpreter.
+ */
+typedef struct {
+  char **items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei_Sources;
+
+/**
+ * Source text edited in place whose tokens and procedures are kept between compilations, see qleei_document_new.
+ */
+typedef struct Qleei_Document Qleei_Document;
+
 /**
  * The main Qleei interpreter state, containing the lexer, stack, custom words, and user procedures.
  */
 typedef struct {
   QLeei_Lexer  lexer;
+  Qleei_Tokens tokens; // Tokens of the lexer's buffer, lexed all at once when compiling
+  Qleei_Symbols symbols; // Identifiers the lexer interned while compiling, kept for the life of the interpreter
+  Qleei_Line_Starts lines; // Starts of the lines errors were reported in
   Qleei_Stack  stack;
   Qleei_Custom_Words words;
   Qleei_Procs  procs;
+  Qleei_Code   code;
+  Qleei_Frames frames; // Return stack of the procedure calls being executed
+  Qleei_Sources sources; // Input read by qleei_interpreter_exec_fd that procedures or `code` still point into
+  qleei_uisz_t epoch;  // Changes whenever words or procedures are added or removed, so calls resolve their name again
+  Qleei_Document *document; // Document owning the interpreter, its procedures are reused while compiling
+  qleei_uisz_t pc;
+  bool   compiled;
   bool   done;
 } Qleei_Interpreter;
 
@@ -599,9 +1157,9 @@ void qleei_interpreter_lexer_init(Qleei_Interpreter *it, const char *input_path,
  * Register a word with a handler.
  *
  * @param it Interpreter to register with.
- * @param word Word to register (must not be a builtin).
+ * @param word Word to register (must not be a builtin or a procedure).
  * @param handler Function to call when the word is encountered.
- * @returns `true` if registered successfully, `false` if word is a builtin or on error.
+ * @returns `true` if registered successfully, `false` if word is a builtin or a procedure, or on error.
  */
 bool qleei_interpreter_register_word(Qleei_Interpreter *it, const char *word, Qleei_Word_Handler handler);
 
@@ -609,13 +1167,28 @@ bool qleei_interpreter_register_word(Qleei_Interpreter *it, const char *word, Ql
  * Register a word with a handler and user data.
  *
  * @param it Interpreter to register with.
- * @param word Word to register (must not be a builtin).
+ * @param word Word to register (must not be a builtin or a procedure).
  * @param handler Function to call when the word is encountered.
  * @param user_data Data to pass to the handler.
- * @returns `true` if registered successfully, `false` if word is a builtin or on error.
+ * @returns `true` if registered successfully, `false` if word is a builtin or a procedure, or on error.
  */
 bool qleei_interpreter_register_word_with_data(Qleei_Interpreter *it, const char *word, Qleei_Word_Handler handler, void *user_data);
 
+/**
+ * Register a word whose inputs and outputs are declared up front.
+ *
+ * The interpreter checks the inputs before every call, so the handler does not pop, push or check
+ * anything and only reads and writes the stack slots it is given.
+ *
+ * @param it Interpreter to register with.
+ * @param word Word to register (must not be a builtin or a procedure).
+ * @param handler Function to call when the word is encountered.
+ * @param signature Kinds the word consumes and produces, must outlive the registration.
+ * @param user_data Data to pass to the handler; may be NULL to receive the interpreter.
+ * @returns `true` if registered successfully, `false` if word is a builtin or a procedure, or on error.
+ */
+bool qleei_interpreter_register_fast_word(Qleei_Interpreter *it, const char *word, Qleei_Fast_Word_Handler handler, const Qleei_Word_Signature *signature, void *user_data);
+
 /**
  * Unregister a word.
  *
@@ -626,15 +1199,15 @@ bool qleei_interpreter_register_word_with_data(Qleei_Interpreter *it, const char
 bool qleei_interpreter_unregister_word(Qleei_Interpreter *it, const char *word);
 
 /**
- * Execute a single token.
+ * Execute a single instruction, compiling the interpreter's input first if it was not compiled yet.
  *
  * @param it Interpreter to step.
- * @returns `true` if the token was executed successfully, `false` on error.
+ * @returns `true` if the instruction was executed successfully, `false` on error.
  */
 bool qleei_interpreter_step(Qleei_Interpreter *it);
 
 /**
- * Run the interpreter until completion or error.
+ * Compile the interpreter's input if needed and run the resulting bytecode until completion or error.
  *
  * @param it Interpreter to run.
  * @returns `true` if execution completed, `false` on error.
@@ -721,67 +1294,218 @@ double qleei_value_item_as_number(Qleei_Value_Item item);
 bool qleei_value_item_as_bool(Qleei_Value_Item item);
 
 /**
- * Execute a while loop whose `while` token has already been consumed, using the interpreter state.
+ * Compile the interpreter's lexer input into `it->code`.
+ *
+ * Literals, symbols and identifiers become one instruction each, `while`/`begin`/`end` become jumps and
+ * the condition of a loop is replayed after its body so every iteration only takes a single jump.
+ * `proc` definitions are compiled by `qleei_parse_proc` into their own code and registered into `it->procs`.
+ * Builtin words are bound while compiling, other identifiers are resolved when their instruction executes.
+ * On success `it->pc` points at the first instruction and `it->compiled` is set.
  *
- * @param it Interpreter instance whose lexer and stack are used and modified during loop execution.
- * @param inside_of_proc True if the loop is being executed while parsing/executing inside a procedure; affects execution context.
- * @returns `true` if the loop completed successfully, `false` on error.
+ * @param it Interpreter whose lexer provides the source; it is advanced up to the end of the input.
+ * @returns `true` if the whole input compiled, `false` on lexer failure or syntax errors.
  */
-bool qleei_execute_while(Qleei_Interpreter *it, bool inside_of_proc);
+bool qleei_compile(Qleei_Interpreter *it);
 
 /**
- * Execute a single token within the given interpreter, performing stack, memory,
- * I/O, control-flow, and procedure-related actions and updating interpreter state.
+ * Print how many superinstructions were fused for every fusion pattern in the compiled program and its procedures.
  *
- * @param it Interpreter instance to operate on; its stack, procs, lexer state and
- *           completion flag may be modified.
- * @param inside_of_proc Set to true when the token is being executed while
- *                       parsing/executing a procedure body (affects allowed actions).
- * @param t Token to execute.
- * @returns `true` if the token was handled successfully, `false` on error.
+ * Fixed sequences such as `dup N +` or `N rot2 mem_save_ui8` are fused into a single instruction after a block is
+ * compiled, the report helps tuning the pattern table against real scripts.
+ *
+ * @param it Interpreter whose program has been compiled.
  */
-bool qleei_execute_token(Qleei_Interpreter *it, bool inside_of_proc, QLeei_Token t);
+void qleei_print_fusion_report(Qleei_Interpreter *it);
 
 /**
  * Parse a procedure declaration starting at the current lexer position and register it with the interpreter.
  *
- * Parses a procedure name, its input and output type lists (e.g. `[] -> []`), and the procedure body (captures nested
- * `while`/`end` depth). On success the constructed Qleei_Proc is appended to the interpreter's procs list.
+ * Parses a procedure name, its input and output type lists (e.g. `[] -> []`), and compiles the procedure body
+ * up to its closing `end` into the procedure's own code. On success the constructed Qleei_Proc is appended to
+ * the interpreter's procs list, calling it never touches the lexer again.
  *
- * @param it Interpreter whose embedded lexer is positioned at the `proc` keyword; the function advances the lexer
+ * @param it Interpreter whose embedded lexer is positioned right after the `proc` keyword; the function advances the lexer
  *           as it consumes tokens.
- * @returns `true` if the procedure was successfully parsed and registered; `false` on lexer failure or syntax errors.
+ * @returns `true` if the procedure header was successfully parsed and registered; `false` on lexer failure or syntax errors.
  */
 bool qleei_parse_proc(Qleei_Interpreter *it);
 
 /**
- * Execute the procedure body defined by `proc` within the interpreter `it`.
- *
- * The lexer and interpreter state are advanced through the procedure body until an `end`
- * token is encountered; the interpreter's stack and other runtime state may be modified
- * by executing the procedure's tokens. On successful completion the original lexer
- * position is restored.
+ * Execute the instruction at `*pc` in `code` and advance `*pc` to the next instruction to run.
  *
- * @param it Interpreter instance whose lexer and runtime state will be used and modified.
- * @param proc Procedure descriptor containing the saved body start location to execute.
- * @returns `true` if the procedure body completed successfully and the original lexer
- *          position was restored, `false` if execution failed (lexer/state remains at
- *          the failure point).
+ * @param it Interpreter instance to operate on; its stack, procs and completion flag may be modified.
+ * @param code Code the instruction belongs to.
+ * @param pc Index of the instruction to execute; updated to the index of the following instruction.
+ * @param inside_of_proc Set to true when the instruction belongs to a procedure body.
+ * @returns `true` if the instruction was handled successfully, `false` on error.
  */
-bool qleei_execute_proc(Qleei_Interpreter *it, Qleei_Proc *proc);
+bool qleei_execute_op(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t *pc, bool inside_of_proc);
 
-#ifdef PLATFORM_BROWSER
+/**
+ * Execute instructions starting at `*pc` until a `QLEEI_OP_HALT` or `QLEEI_OP_RETURN` is reached.
+ *
+ * On desktop builds compiled with GCC or Clang the instructions are dispatched with computed gotos,
+ * other builds use a `switch`.
+ * The top of the stack is kept out of `it->stack` while instructions run and written back before
+ * anything else can observe the stack, such as words, procedures or returning from this function.
+ * Procedures are called without recursing: their caller is pushed to `it->frames`, up to QLEEI_MAX_CALL_DEPTH
+ * nested calls, and a call followed by the caller's own return reuses the caller's frame.
+ *
+ * @param it Interpreter instance to operate on.
+ * @param code Code to execute.
+ * @param pc Index of the first instruction to execute; updated as execution advances.
+ * @param inside_of_proc Set to true when executing a procedure body.
+ * @returns `true` if execution stopped at a halt or return, `false` on error.
+ */
+bool qleei_execute_code(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t *pc, bool inside_of_proc);
+
+/**
+ * Execute the compiled body of `proc` within the interpreter `it`.
+ *
+ * The body is compiled assuming its inputs are on the stack, check them with qleei_proc_check_inputs first.
+ *
+ * @param it Interpreter instance whose runtime state will be used and modified.
+ * @param proc Procedure whose compiled body will be executed.
+ * @returns `true` if the procedure body completed successfully, `false` if execution failed.
+ */
+bool qleei_execute_proc(Qleei_Interpreter *it, Qleei_Proc *proc);
+
+/**
+ * Create an empty document, for editors compiling the same source over and over as it is edited.
+ *
+ * Edits only splice the source. Compiling lexes again the tokens around the bytes edited since the last compilation,
+ * up to the first token found unchanged after them, and takes the procedures whose tokens didn't change from the last
+ * compilation instead of compiling them again. Their bodies are verified again once a procedure before them changed.
+ *
+ * @param input_path Path for error messages (may be NULL), it is copied.
+ * @returns The document, or `NULL` if allocation failed.
+ */
+Qleei_Document *qleei_document_new(const char *input_path);
+
+/**
+ * Replace `removed` bytes of the document's source at `start` with `text`.
+ *
+ * @param doc Document to edit.
+ * @param start Index in the source of the first byte replaced.
+ * @param removed Number of bytes replaced, they must be within the source.
+ * @param text Bytes to insert in their place, they are copied.
+ * @param text_len Number of bytes to insert.
+ * @returns `true` if the source was edited, `false` if the range is out of the source or allocation failed.
+ */
+bool qleei_document_edit(Qleei_Document *doc, qleei_uisz_t start, qleei_uisz_t removed, const char *text, qleei_uisz_t text_len);
+
+/**
+ * Compile the document's source into its interpreter, ready to be executed from the start on an empty stack.
+ *
+ * @param doc Document to compile.
+ * @returns `true` if the source compiled, `false` on lexing or compile errors, which were reported.
+ */
+bool qleei_document_compile(Qleei_Document *doc);
+
+/**
+ * Get the interpreter the document compiles into, register custom words on it before compiling.
+ */
+Qleei_Interpreter *qleei_document_interpreter(Qleei_Document *doc);
+
+/**
+ * Free the document along with its interpreter.
+ */
+void qleei_document_free(Qleei_Document *doc);
+
+#ifdef PLATFORM_BROWSER
 
-extern double qleei_wasm_parse_number(const char *buf, qleei_uisz_t buf_size);
 extern void   qleei_wasm_printf(const char *fmt, ...);
 extern void   qleei_wasm_printfn(const char *fmt, ...);
 extern void   qleei_wasm_mfree(void *ptr);
 extern void*  qleei_wasm_malloc(qleei_uisz_t bytes_count);
 extern void*  qleei_wasm_mrealloc(void *base_ptr, qleei_uisz_t bytes_count);
+extern void*  qleei_wasm_program_malloc(qleei_uisz_t bytes_count);
 
 #define qleei_printf  qleei_wasm_printf
 #define qleei_printfn qleei_wasm_printfn
 
+/**
+ * A program translated to its own WebAssembly module, so the playground can run it without interpreting it.
+ */
+typedef struct Qleei_Wasm_Program Qleei_Wasm_Program;
+
+/**
+ * Compile a buffer of Qleei source and translate it into a WebAssembly module.
+ *
+ * The module imports `env.memory`, which must be the memory of the module this function runs in, along with
+ * `env.qleei_wasm_program_execute_op`, `env.qleei_wasm_program_check_call`, `env.qleei_wasm_program_call_too_deep`
+ * and `env.qleei_wasm_program_call`.
+ * It exports `main`, which takes the program's interpreter and returns 1 once the program halts or 0 on error.
+ * Instructions are referenced by address so the module can only run while the program is alive.
+ *
+ * @param input_path Path for error messages (may be NULL).
+ * @param buffer Source buffer, it must outlive the program.
+ * @param buf_size Size of the source buffer.
+ * @returns The translated program, or `NULL` if the source failed to compile.
+ */
+Qleei_Wasm_Program *qleei_wasm_program_new(const char *input_path, const char *buffer, qleei_uisz_t buf_size);
+
+/**
+ * Compile a document and translate it into a WebAssembly module like qleei_wasm_program_new does.
+ *
+ * The program runs on the document's interpreter, the document must outlive it and not be compiled again before the
+ * program is freed.
+ *
+ * @param doc Document to compile.
+ * @returns The translated program, or `NULL` if the document failed to compile.
+ */
+Qleei_Wasm_Program *qleei_wasm_program_from_document(Qleei_Document *doc);
+
+/**
+ * Get the bytes of the program's module.
+ */
+const qleei_ui8_t *qleei_wasm_program_module(Qleei_Wasm_Program *program);
+
+/**
+ * Get the size in bytes of the program's module.
+ */
+qleei_uisz_t qleei_wasm_program_module_size(Qleei_Wasm_Program *program);
+
+/**
+ * Get the interpreter the program's module runs on, to be passed to its `main`.
+ */
+Qleei_Interpreter *qleei_wasm_program_interpreter(Qleei_Wasm_Program *program);
+
+/**
+ * Free the program along with its module, and its interpreter unless it belongs to a document.
+ */
+void qleei_wasm_program_free(Qleei_Wasm_Program *program);
+
+/**
+ * Imported by program modules: execute the instruction at `pc` of `code` through the interpreter.
+ *
+ * @returns `true` if the instruction was handled successfully, `false` on error.
+ */
+bool qleei_wasm_program_execute_op(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, bool inside_of_proc);
+
+/**
+ * Imported by program modules: check the inputs of `proc` before the call at `pc` of `code` runs it.
+ *
+ * @returns `true` if the procedure can be called, `false` otherwise.
+ */
+bool qleei_wasm_program_check_call(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, Qleei_Proc *proc);
+
+/**
+ * Imported by program modules: report that the call at `pc` of `code` would nest more than QLEEI_MAX_CALL_DEPTH
+ * procedure calls, the way the interpreter does.
+ *
+ * @returns `false`, the call fails.
+ */
+bool qleei_wasm_program_call_too_deep(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, Qleei_Proc *proc);
+
+/**
+ * Imported by program modules: run the call at `pc` of `code` to a procedure that can recurse through the
+ * interpreter, after `depth` procedure calls already nesting in the module.
+ *
+ * @returns `true` if the call returned successfully, `false` on error.
+ */
+bool qleei_wasm_program_call(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, qleei_uisz_t depth);
+
 #endif // PLATFORM_BROWSER
 
 
@@ -793,6 +1517,34 @@ extern void*  qleei_wasm_mrealloc(void *base_ptr, qleei_uisz_t bytes_count);
 void qleei_printf(const char *fmt, ...);
 void qleei_printfn(const char *fmt, ...);
 
+/**
+ * Translate the compiled program held by the interpreter into a standalone C file.
+ *
+ * The program is compiled first if it wasn't already. The generated file defines `bool qleei_aot_main(Qleei_Interpreter *it)`
+ * which runs the program natively: `while` loops become `goto`s, procedures become C functions and everything that
+ * can't be inlined or may report an error goes through qleei_execute_op, so custom words registered on `it` keep working.
+ *
+ * @param it Interpreter with the program's source loaded and its custom words registered.
+ * @param out Stream the C source is written to.
+ * @returns `true` if the program compiled and was written, `false` otherwise.
+ */
+bool qleei_translate_to_c(Qleei_Interpreter *it, FILE *out);
+
+/**
+ * Execute a program read from a file descriptor, running every top level part of it as soon as it was read.
+ *
+ * The input is read in chunks and cut after the lines that leave no `while` loop or procedure open. Each part is
+ * compiled and executed before more input is read, on the same stack, procedures and words. A part naming a
+ * procedure that isn't defined yet waits until its definition was read, a name that is never defined holds back the
+ * rest of the input until it ends. Only the part being read and the parts defining procedures are kept.
+ *
+ * @param it Interpreter to execute on, with its custom words registered.
+ * @param input_path Path for error messages (may be NULL).
+ * @param fd File descriptor to read the program from, for example 0 for the standard input.
+ * @returns `true` if the whole input was executed, `false` on read, compile or execution errors.
+ */
+bool qleei_interpreter_exec_fd(Qleei_Interpreter *it, const char *input_path, int fd);
+
 #endif // PLATFORM_DESKTOP
 
 
@@ -950,10 +1702,10 @@ static bool qleei__word_print_number(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  switch (item.kind) {
-  case QLEEI_VALUE_KIND_NUMBER:   qleei_printfn("%.4f", item.as_number.value); break;
-  case QLEEI_VALUE_KIND_BOOL:     qleei_printfn("%d", (int)item.as_bool.value); break;
-  case QLEEI_VALUE_KIND_POINTER:  qleei_printfn("%zu", (qleei_uisz_t)item.as_pointer.value); break;
+  switch (qleei_value_item_kind(item)) {
+  case QLEEI_VALUE_KIND_NUMBER:   qleei_printfn("%.4f", qleei_value_item_number(item)); break;
+  case QLEEI_VALUE_KIND_BOOL:     qleei_printfn("%d", (int)qleei_value_item_bool(item)); break;
+  case QLEEI_VALUE_KIND_POINTER:  qleei_printfn("%zu", (qleei_uisz_t)qleei_value_item_pointer(item)); break;
   }
   return true;
 }
@@ -962,10 +1714,10 @@ static bool qleei__word_print_uisz(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  switch (item.kind) {
-  case QLEEI_VALUE_KIND_NUMBER:   qleei_printfn("%zu", (qleei_uisz_t)item.as_number.value); break;
-  case QLEEI_VALUE_KIND_BOOL:    qleei_printfn("%zu", (qleei_uisz_t)item.as_bool.value); break;
-  case QLEEI_VALUE_KIND_POINTER:  qleei_printfn("%zu", (qleei_uisz_t)item.as_pointer.value); break;
+  switch (qleei_value_item_kind(item)) {
+  case QLEEI_VALUE_KIND_NUMBER:   qleei_printfn("%zu", (qleei_uisz_t)qleei_value_item_number(item)); break;
+  case QLEEI_VALUE_KIND_BOOL:    qleei_printfn("%zu", (qleei_uisz_t)qleei_value_item_bool(item)); break;
+  case QLEEI_VALUE_KIND_POINTER:  qleei_printfn("%zu", (qleei_uisz_t)qleei_value_item_pointer(item)); break;
   }
   return true;
 }
@@ -974,8 +1726,8 @@ static bool qleei__word_print_ptr(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item.kind, QLEEI_VALUE_KIND_POINTER)) return false;
-  qleei_printfn("%p", item.as_pointer.value);
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(item), QLEEI_VALUE_KIND_POINTER)) return false;
+  qleei_printfn("%p", qleei_value_item_pointer(item));
   return true;
 }
 
@@ -983,8 +1735,8 @@ static bool qleei__word_print_char(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (item.kind != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] Invalid item type passed to print_char"); return false; }
-  double n = item.as_number.value;
+  if (qleei_value_item_kind(item) != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] Invalid item type passed to print_char"); return false; }
+  double n = qleei_value_item_number(item);
   if (0 > n || n > 255) { qleei_printfn("[ERROR] Attempting to read a number as a char that exceeds the char limit of 255: %zu", (qleei_uisz_t)n); return false; }
   qleei_printfn("%c", (char)n);
   return true;
@@ -994,8 +1746,8 @@ static bool qleei__word_print_bool(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (item.kind != QLEEI_VALUE_KIND_BOOL) { qleei_printfn("[ERROR] Invalid item type passed to print_bool"); return false; }
-  qleei_printfn(item.as_bool.value ? "true" : "false");
+  if (qleei_value_item_kind(item) != QLEEI_VALUE_KIND_BOOL) { qleei_printfn("[ERROR] Invalid item type passed to print_bool"); return false; }
+  qleei_printfn(qleei_value_item_bool(item) ? "true" : "false");
   return true;
 }
 
@@ -1008,8 +1760,8 @@ static bool qleei__word_print_zstr(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (item.kind != QLEEI_VALUE_KIND_POINTER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected pointer", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
-  qleei_printfn("%s", (char*)item.as_pointer.value);
+  if (qleei_value_item_kind(item) != QLEEI_VALUE_KIND_POINTER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected pointer", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
+  qleei_printfn("%s", qleei_value_item_pointer(item));
   return true;
 }
 
@@ -1069,10 +1821,9 @@ static bool qleei__word_mem_alloc(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (item.kind != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected number", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
-  void *ptr = qleei_mem_alloc((qleei_uisz_t)item.as_number.value);
-  item.as_pointer.kind = QLEEI_VALUE_KIND_POINTER;
-  item.as_pointer.value = ptr;
+  if (qleei_value_item_kind(item) != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected number", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
+  void *ptr = qleei_program_mem_alloc((qleei_uisz_t)qleei_value_item_number(item));
+  item = qleei_value_item_from_pointer(ptr);
   qleei_alist_append(opt.stack, &item);
   return true;
 }
@@ -1081,19 +1832,19 @@ static bool qleei__word_mem_free(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (item.kind != QLEEI_VALUE_KIND_POINTER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected pointer", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
-  qleei_mem_free(item.as_pointer.value);
+  if (qleei_value_item_kind(item) != QLEEI_VALUE_KIND_POINTER) { qleei_printfn("[ERROR] Invalid type passed to "QLEEI_SV_Fmt_Str" expected pointer", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
+  qleei_mem_free(qleei_value_item_pointer(item));
   return true;
 }
 
 static bool qleei__word_mem_save_si8(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 2)) return false;
-  Qleei_Value_Item ptr_item, val_item;
+  Qleei_Value_Item ptr_item = {0}, val_item = {0};
   qleei_alist_pop(opt.stack, &ptr_item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, ptr_item.kind, QLEEI_VALUE_KIND_POINTER)) return false;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(ptr_item), QLEEI_VALUE_KIND_POINTER)) return false;
   qleei_alist_pop(opt.stack, &val_item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, val_item.kind, QLEEI_VALUE_KIND_NUMBER)) return false;
-  *(qleei_si8_t*)ptr_item.as_pointer.value = (qleei_si8_t)val_item.as_number.value;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(val_item), QLEEI_VALUE_KIND_NUMBER)) return false;
+  *(qleei_si8_t*)qleei_value_item_pointer(ptr_item) = (qleei_si8_t)qleei_value_item_number(val_item);
   return true;
 }
 
@@ -1101,10 +1852,10 @@ static bool qleei__word_mem_save_ui8(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 2)) return false;
   Qleei_Value_Item ptr_item, val_item;
   qleei_alist_pop(opt.stack, &ptr_item);
-  if (ptr_item.kind != QLEEI_VALUE_KIND_POINTER) { qleei_loc_printfn(opt.token.loc, "[ERROR] "QLEEI_SV_Fmt_Str" requires a pointer at the top of the stack", QLEEI_SV_Fmt_Arg(opt.token.string)); qleei_printf("[NOTE] Current stack: "); qleei_print_stack(opt.stack); return false; }
+  if (qleei_value_item_kind(ptr_item) != QLEEI_VALUE_KIND_POINTER) { qleei_loc_printfn(opt.token.loc, "[ERROR] "QLEEI_SV_Fmt_Str" requires a pointer at the top of the stack", QLEEI_SV_Fmt_Arg(opt.token.string)); qleei_printf("[NOTE] Current stack: "); qleei_print_stack(opt.stack); return false; }
   qleei_alist_pop(opt.stack, &val_item);
-  if (val_item.kind != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] "QLEEI_SV_Fmt_Str" requires a number second to the top of the stack", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
-  *(qleei_ui8_t*)ptr_item.as_pointer.value = (qleei_ui8_t)val_item.as_number.value;
+  if (qleei_value_item_kind(val_item) != QLEEI_VALUE_KIND_NUMBER) { qleei_printfn("[ERROR] "QLEEI_SV_Fmt_Str" requires a number second to the top of the stack", QLEEI_SV_Fmt_Arg(opt.token.string)); return false; }
+  *(qleei_ui8_t*)qleei_value_item_pointer(ptr_item) = (qleei_ui8_t)qleei_value_item_number(val_item);
   return true;
 }
 
@@ -1112,9 +1863,8 @@ static bool qleei__word_mem_load_ui8(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item.kind, QLEEI_VALUE_KIND_POINTER)) return false;
-  item.as_number.kind = QLEEI_VALUE_KIND_NUMBER;
-  item.as_number.value = *(qleei_ui8_t*)item.as_pointer.value;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(item), QLEEI_VALUE_KIND_POINTER)) return false;
+  item = qleei_value_item_from_number(*(qleei_ui8_t*)qleei_value_item_pointer(item));
   qleei_alist_append(opt.stack, &item);
   return true;
 }
@@ -1124,9 +1874,9 @@ static bool qleei__word_mem_save_ui32(Qleei_Word_Handler_Opt opt) {
   Qleei_Value_Item ptr_item, val_item;
   qleei_alist_pop(opt.stack, &ptr_item);
   qleei_alist_pop(opt.stack, &val_item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, ptr_item.kind, QLEEI_VALUE_KIND_POINTER)) return false;
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, val_item.kind, QLEEI_VALUE_KIND_NUMBER)) return false;
-  *(qleei_ui32_t*)ptr_item.as_pointer.value = (qleei_ui32_t)val_item.as_number.value;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(ptr_item), QLEEI_VALUE_KIND_POINTER)) return false;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(val_item), QLEEI_VALUE_KIND_NUMBER)) return false;
+  *(qleei_ui32_t*)qleei_value_item_pointer(ptr_item) = (qleei_ui32_t)qleei_value_item_number(val_item);
   return true;
 }
 
@@ -1134,23 +1884,17 @@ static bool qleei__word_mem_load_ui32(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item;
   qleei_alist_pop(opt.stack, &item);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item.kind, QLEEI_VALUE_KIND_POINTER)) return false;
-  item.as_number.kind = QLEEI_VALUE_KIND_NUMBER;
-  item.as_number.value = *(qleei_ui32_t*)item.as_pointer.value;
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(item), QLEEI_VALUE_KIND_POINTER)) return false;
+  item = qleei_value_item_from_number(*(qleei_ui32_t*)qleei_value_item_pointer(item));
   qleei_alist_append(opt.stack, &item);
   return true;
 }
 
-static bool qleei__word_proc(Qleei_Word_Handler_Opt opt) {
-  if (opt.inside_proc) {
-    qleei_printfn("[ERROR] Cannot define a procedure while inside of a procedure");
-    return false;
-  }
-  return qleei_parse_proc((Qleei_Interpreter*)opt.user_data);
-}
-
-static bool qleei__word_while(Qleei_Word_Handler_Opt opt) {
-  return qleei_execute_while((Qleei_Interpreter*)opt.user_data, opt.inside_proc);
+// `proc` and `while` are consumed by the compiler and never reach a handler, they stay in
+// the builtin table so they can't be registered as custom words or used as procedure names
+static bool qleei__word_keyword(Qleei_Word_Handler_Opt opt) {
+  qleei_loc_printfn(opt.token.loc, "[UNREACHABLE] Keyword '"QLEEI_SV_Fmt_Str"' reached a word handler", QLEEI_SV_Fmt_Arg(opt.token.string));
+  return false;
 }
 
 static bool qleei__word_if(Qleei_Word_Handler_Opt opt) {
@@ -1160,8 +1904,8 @@ static bool qleei__word_if(Qleei_Word_Handler_Opt opt) {
 }
 
 static Qleei_Custom_Word QLEEI_BUILTIN_WORDS[] = {
-  { "proc",           { .handler = qleei__word_proc,          .user_data = NULL } },
-  { "while",          { .handler = qleei__word_while,         .user_data = NULL } },
+  { "proc",           { .handler = qleei__word_keyword,       .user_data = NULL } },
+  { "while",          { .handler = qleei__word_keyword,       .user_data = NULL } },
   { "if",             { .handler = qleei__word_if,            .user_data = NULL } },
   { "print_number",   { .handler = qleei__word_print_number,  .user_data = NULL } },
   { "print_uisz",     { .handler = qleei__word_print_uisz,    .user_data = NULL } },
@@ -1250,13 +1994,137 @@ bool qleei_value_kind_list_append(Qleei_Value_Kind **items, qleei_uisz_t *cap, q
   return qleei_list_append((void**)items, sizeof(Qleei_Value_Kind), cap, len, &item);
 }
 
+const char *qleei_get_op_kind_name(Qleei_Op_Kind kind) {
+  switch (kind) {
+  case QLEEI_OP_NONE:        return "NONE";
+  case QLEEI_OP_HALT:        return "HALT";
+  case QLEEI_OP_PUSH_NUMBER: return "PUSH_NUMBER";
+  case QLEEI_OP_PUSH_BOOL:   return "PUSH_BOOL";
+  case QLEEI_OP_ADD:         return "ADD";
+  case QLEEI_OP_SUB:         return "SUB";
+  case QLEEI_OP_MUL:         return "MUL";
+  case QLEEI_OP_DIV:         return "DIV";
+  case QLEEI_OP_ABORT:       return "ABORT";
+  case QLEEI_OP_DUP:         return "DUP";
+  case QLEEI_OP_OVER:        return "OVER";
+  case QLEEI_OP_DROP:        return "DROP";
+  case QLEEI_OP_ROT2:        return "ROT2";
+  case QLEEI_OP_SWAP3:       return "SWAP3";
+  case QLEEI_OP_ROT3:        return "ROT3";
+  case QLEEI_OP_BUILTIN:     return "BUILTIN";
+  case QLEEI_OP_DUP_PUSH_ADD:       return "DUP_PUSH_ADD";
+  case QLEEI_OP_PUSH_ADD:           return "PUSH_ADD";
+  case QLEEI_OP_PUSH_ROT2_SUB:      return "PUSH_ROT2_SUB";
+  case QLEEI_OP_PUSH_ROT2_SAVE_UI8: return "PUSH_ROT2_SAVE_UI8";
+  case QLEEI_OP_SQUARE:             return "SQUARE";
+  case QLEEI_OP_CUBE:               return "CUBE";
+  case QLEEI_OP_ADD_NUMBERS:        return "ADD_NUMBERS";
+  case QLEEI_OP_SUB_NUMBERS:        return "SUB_NUMBERS";
+  case QLEEI_OP_MUL_NUMBERS:        return "MUL_NUMBERS";
+  case QLEEI_OP_DIV_NUMBERS:        return "DIV_NUMBERS";
+  case QLEEI_OP_CALL:        return "CALL";
+  case QLEEI_OP_JUMP:        return "JUMP";
+  case QLEEI_OP_JUMP_UNLESS: return "JUMP_UNLESS";
+  case QLEEI_OP_JUMP_IF:     return "JUMP_IF";
+  case QLEEI_OP_RETURN:      return "RETURN";
+  }
+  return "<Unknown>";
+}
+
+bool qleei_code_emit(Qleei_Code *code, Qleei_Op op, QLeei_Token token) {
+  Qleei_Call_Cache cache = {0};
+  if (!qleei_alist_append(&code->calls, &cache)) return false;
+  if (!qleei_alist_append(&code->tokens, &token)) {
+    code->calls.len--;
+    return false;
+  }
+  if (!qleei_alist_append(code, &op)) {
+    code->calls.len--;
+    code->tokens.len--;
+    return false;
+  }
+  return true;
+}
+
+void qleei_code_free(Qleei_Code *code) {
+  qleei_alist_free(&code->calls);
+  qleei_alist_free(&code->tokens);
+  qleei_alist_free(code);
+}
+
+// FNV-1a, `seed` is mixed into the offset basis
+static qleei_ui32_t qleei__hash_sv(Qleei_String_View sv, qleei_ui32_t seed) {
+  qleei_ui32_t hash = 2166136261u ^ seed;
+  for (qleei_uisz_t i = 0; i < sv.len; ++i) {
+    hash ^= (qleei_ui8_t)sv.data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Slot of `name` in the index, or the free slot where it would go. The index always has a free slot
+static qleei_uisz_t qleei__procs_slot(Qleei_Procs *procs, Qleei_String_View name) {
+  qleei_uisz_t mask = procs->index.cap - 1;
+  qleei_uisz_t slot = qleei__hash_sv(name, 0) & mask;
+  while (procs->index.items[slot] != 0 && !qleei_sv_eq_sv(procs->items[procs->index.items[slot] - 1].name_sv, name)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+// Keeps at least half of the slots free, growing rehashes every procedure
+static bool qleei__procs_index_grow(Qleei_Procs *procs) {
+  if ((procs->index.len + 1)*2 <= procs->index.cap) return true;
+  qleei_uisz_t cap = procs->index.cap == 0 ? 16 : procs->index.cap*2;
+  qleei_uisz_t *slots = qleei_mem_alloc(cap*sizeof(qleei_uisz_t));
+  if (slots == NULL) return false;
+  if (procs->index.items != NULL) qleei_mem_free(procs->index.items);
+  procs->index.items = slots;
+  procs->index.cap = cap;
+  procs->index.len = 0;
+  for (qleei_uisz_t i = 0; i < cap; ++i) slots[i] = 0;
+  for (qleei_uisz_t i = 0; i < procs->len; ++i) {
+    qleei_uisz_t slot = qleei__procs_slot(procs, procs->items[i].name_sv);
+    if (slots[slot] != 0) continue;
+    slots[slot] = i + 1;
+    procs->index.len++;
+  }
+  return true;
+}
+
 Qleei_Proc *qleei_procs_find_by_sv_name(Qleei_Procs *haystack, Qleei_String_View needle) {
-  qleei_alist_foreach(Qleei_Proc, it, haystack) {
-    if (qleei_sv_eq_sv(it->name_sv, needle)) {
-      return it;
+  if (haystack->index.len == 0) return NULL;
+  qleei_uisz_t index = haystack->index.items[qleei__procs_slot(haystack, needle)];
+  return index != 0 ? &haystack->items[index - 1] : NULL;
+}
+
+bool qleei_procs_append(Qleei_Procs *procs, Qleei_Proc proc) {
+  if (!qleei__procs_index_grow(procs)) return false;
+  if (!qleei_alist_append(procs, &proc)) return false;
+  qleei_uisz_t slot = qleei__procs_slot(procs, proc.name_sv);
+  if (procs->index.items[slot] == 0) {
+    procs->index.items[slot] = procs->len;
+    procs->index.len++;
+  }
+  return true;
+}
+
+void qleei_procs_free(Qleei_Procs *procs) {
+  qleei_alist_free(&procs->index);
+  qleei_alist_free(procs);
+}
+
+bool qleei_proc_check_inputs(Qleei_Proc *proc, Qleei_Stack *stack, QLeei_Token token) {
+  if (!qleei_stack_operation_requires_n_items(token.loc, stack, token.string, proc->inputs.len)) return false;
+  for (qleei_uisz_t i = 0; i < proc->inputs.len; ++i) {
+    Qleei_Value_Kind received = qleei_value_item_kind(stack->items[stack->len - (i + 1)]);
+    Qleei_Value_Kind expected = proc->inputs.items[i];
+    if (received != expected) {
+      qleei_printfn("[ERROR] Proc "QLEEI_SV_Fmt_Str" expected %s but got %s", QLEEI_SV_Fmt_Arg(proc->name_sv), qleei_get_value_kind_name(expected), qleei_get_value_kind_name(received));
+      return false;
     }
   }
-  return NULL;
+  return true;
 }
 
 bool qleei_cp_sv_to_buf(Qleei_String_View sv, char *buf, qleei_uisz_t buf_size) {
@@ -1266,178 +2134,1551 @@ bool qleei_cp_sv_to_buf(Qleei_String_View sv, char *buf, qleei_uisz_t buf_size)
   return true;
 }
 
+// The builtin words are looked up through a perfect hash: QLEEI_BUILTIN_HASH_SEED is the first seed that sends every
+// one of them to its own slot, so a lookup is a hash and a single comparison. Both are written by tools/builtin_hash.c
+// through `./nob builtin-hash` when the builtin words change, and every nob build checks that they are up to date
+#define QLEEI_BUILTIN_HASH_SLOTS 128
+#define QLEEI_BUILTIN_HASH_SEED  10u
+
+typedef struct {
+  qleei_ui8_t word; // Index of the builtin word hashing to the slot plus one, 0 for an empty slot
+  qleei_ui8_t len;  // Length of its name
+} Qleei__Builtin_Slot;
+
+static const Qleei__Builtin_Slot QLEEI_BUILTIN_HASH[QLEEI_BUILTIN_HASH_SLOTS] = {
+  [  3] = {  7, 10 }, // print_char
+  [  7] = { 21, 12 }, // mem_save_si8
+  [  9] = { 25, 13 }, // mem_load_ui32
+  [ 10] = {  4, 12 }, // print_number
+  [ 21] = { 12,  4 }, // over
+  [ 22] = { 13,  4 }, // drop
+  [ 34] = { 14,  4 }, // rot2
+  [ 46] = { 15,  5 }, // swap2
+  [ 52] = { 11,  3 }, // dup
+  [ 53] = { 17,  4 }, // rot3
+  [ 58] = { 10, 10 }, // print_zstr
+  [ 60] = {  5, 10 }, // print_uisz
+  [ 61] = {  9, 11 }, // print_stack
+  [ 63] = {  1,  4 }, // proc
+  [ 64] = {  2,  5 }, // while
+  [ 65] = { 16,  5 }, // swap3
+  [ 71] = { 20,  8 }, // mem_free
+  [ 79] = { 18, 12 }, // assert_empty
+  [ 92] = {  3,  2 }, // if
+  [103] = {  6,  9 }, // print_ptr
+  [106] = { 24, 13 }, // mem_save_ui32
+  [109] = { 22, 12 }, // mem_save_ui8
+  [111] = {  8, 10 }, // print_bool
+  [112] = { 23, 12 }, // mem_load_ui8
+  [122] = { 19,  9 }, // mem_alloc
+};
+
+static bool qleei__find_builtin_word(Qleei_String_View sv, qleei_uisz_t *index) {
+  Qleei__Builtin_Slot slot = QLEEI_BUILTIN_HASH[qleei__hash_sv(sv, QLEEI_BUILTIN_HASH_SEED) % QLEEI_BUILTIN_HASH_SLOTS];
+  if (slot.word == 0) return false;
+  Qleei_String_View name = { .data = QLEEI_BUILTIN_WORDS[slot.word - 1].key, .len = slot.len };
+  if (!qleei_sv_eq_sv(sv, name)) return false;
+  *index = slot.word - 1;
+  return true;
+}
+
+#undef QLEEI_BUILTIN_HASH_SLOTS
+#undef QLEEI_BUILTIN_HASH_SEED
+
 static bool qleei_builtin_word_exists(Qleei_String_View sv) {
-  char buf[QLEEI_MAX_WORD_SIZE+1];// +1 for NULL terminator
-  if (!qleei_cp_sv_to_buf(sv, buf, sizeof(buf))) return false;
-  for (qleei_uisz_t i = 0; i < QLEEI_BUILTIN_WORD_COUNT; i++) {
-    if (qleei_zstr_eq(QLEEI_BUILTIN_WORDS[i].key, buf)) return true;
-  }
-  return false;
+  qleei_uisz_t index;
+  return qleei__find_builtin_word(sv, &index);
 }
 
-Qleei_Word_Handler qleei__get_word_handler(Qleei_Interpreter *it, Qleei_String_View sv, void **user_data_out) {
-  char buf[QLEEI_MAX_WORD_SIZE];
-  if (!qleei_cp_sv_to_buf(sv, buf, sizeof(buf))) return NULL;
+// Slot holding `sv`, or the free slot where it would go. The map always has a free slot
+static qleei_uisz_t qleei__custom_words_slot(Qleei_Custom_Words *w, Qleei_String_View sv) {
+  qleei_uisz_t mask = w->cap - 1;
+  qleei_uisz_t slot = qleei__hash_sv(sv, 0) & mask;
+  while (w->items[slot].key != NULL && !qleei_sv_eq_zstr(sv, w->items[slot].key)) slot = (slot + 1) & mask;
+  return slot;
+}
 
-  for (qleei_uisz_t i = 0; i < QLEEI_BUILTIN_WORD_COUNT; i++) {
-    if (qleei_zstr_eq(QLEEI_BUILTIN_WORDS[i].key, buf)) {
-      if (user_data_out) {
-        *user_data_out = QLEEI_BUILTIN_WORDS[i].val.user_data;
-        if (*user_data_out == NULL) *user_data_out = it;
-      }
-      return QLEEI_BUILTIN_WORDS[i].val.handler;
-    }
-  }
+static Qleei_Custom_Word *qleei__custom_words_find(Qleei_Custom_Words *w, Qleei_String_View sv) {
+  if (w->len == 0) return NULL;
+  Qleei_Custom_Word *word = &w->items[qleei__custom_words_slot(w, sv)];
+  return word->key != NULL ? word : NULL;
+}
 
-  for (qleei_uisz_t i = 0; i < it->words.len; i++) {
-    if (qleei_zstr_eq(it->words.items[i].key, buf)) {
-      if (user_data_out) {
-        *user_data_out = it->words.items[i].val.user_data;
-        if (*user_data_out == NULL) *user_data_out = it;
-      }
-      return it->words.items[i].val.handler;
-    }
-  }
+// Keeps at least half of the slots free
+static bool qleei__custom_words_grow(Qleei_Custom_Words *w) {
+  if ((w->len + 1)*2 <= w->cap) return true;
+  qleei_uisz_t cap = w->cap == 0 ? 16 : w->cap*2;
+  Qleei_Custom_Word *items = qleei_mem_alloc(cap*sizeof(Qleei_Custom_Word));
+  if (items == NULL) return false;
+  for (qleei_uisz_t i = 0; i < cap; ++i) items[i] = (Qleei_Custom_Word){0};
 
-  return NULL;
+  Qleei_Custom_Words grown = { .items = items, .len = w->len, .cap = cap };
+  for (qleei_uisz_t i = 0; i < w->cap; ++i) {
+    if (w->items[i].key == NULL) continue;
+    grown.items[qleei__custom_words_slot(&grown, qleei_sv_from_zstr(w->items[i].key))] = w->items[i];
+  }
+  if (w->items != NULL) qleei_mem_free(w->items);
+  *w = grown;
+  return true;
 }
 
 bool qleei_custom_words_add(Qleei_Custom_Words *w, const char *word, Qleei_Word_Handler handler, void *user_data) {
   if (w == NULL || word == NULL || handler == NULL) return false;
-  for (qleei_uisz_t i = 0; i < w->len; i++) {
-    if (qleei_zstr_eq(w->items[i].key, word)) {
-      w->items[i].val.handler = handler;
-      w->items[i].val.user_data = user_data;
-      return true;
-    }
-  }
-  Qleei_Custom_Word item = { .key = word, .val = { .handler = handler, .user_data = user_data } };
-  return qleei_alist_append(w, &item);
+  if (!qleei__custom_words_grow(w)) return false;
+  Qleei_Custom_Word *item = &w->items[qleei__custom_words_slot(w, qleei_sv_from_zstr(word))];
+  if (item->key == NULL) w->len++;
+  *item = (Qleei_Custom_Word){ .key = word, .val = { .handler = handler, .user_data = user_data } };
+  return true;
+}
+
+bool qleei_custom_words_add_fast(Qleei_Custom_Words *w, const char *word, Qleei_Fast_Word_Handler handler, const Qleei_Word_Signature *signature, void *user_data) {
+  if (w == NULL || word == NULL || handler == NULL || signature == NULL) return false;
+  if (signature->inputs_len > QLEEI_WORD_MAX_ITEMS || signature->outputs_len > QLEEI_WORD_MAX_ITEMS) return false;
+  if (!qleei__custom_words_grow(w)) return false;
+  Qleei_Custom_Word *item = &w->items[qleei__custom_words_slot(w, qleei_sv_from_zstr(word))];
+  if (item->key == NULL) w->len++;
+  *item = (Qleei_Custom_Word){ .key = word, .val = { .fast = handler, .signature = signature, .user_data = user_data } };
+  return true;
 }
 
 bool qleei_custom_words_remove(Qleei_Custom_Words *w, const char *word) {
-  if (w == NULL || word == NULL) return false;
-  for (qleei_uisz_t i = w->len; i > 0; i--) {
-    if (qleei_zstr_eq(w->items[i - 1].key, word)) {
-      if (i < w->len) w->items[i - 1] = w->items[w->len - 1];
-      w->len--;
-      return true;
+  if (w == NULL || word == NULL || w->len == 0) return false;
+  qleei_uisz_t mask = w->cap - 1;
+  qleei_uisz_t hole = qleei__custom_words_slot(w, qleei_sv_from_zstr(word));
+  if (w->items[hole].key == NULL) return false;
+
+  // Words after the hole move back into it unless that would put them before their own slot
+  for (qleei_uisz_t i = (hole + 1) & mask; w->items[i].key != NULL; i = (i + 1) & mask) {
+    qleei_uisz_t home = qleei__hash_sv(qleei_sv_from_zstr(w->items[i].key), 0) & mask;
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      w->items[hole] = w->items[i];
+      hole = i;
     }
   }
-  return false;
+  w->items[hole] = (Qleei_Custom_Word){0};
+  w->len--;
+  return true;
 }
 
+// ==================================================
+// Symbols
+// --------------------------------------------------
+// The lexer interns every identifier so the compiler tells keywords apart by id and looks names up once per symbol
+// instead of once per occurrence. What a symbol names is resolved again whenever the interpreter's `epoch` changes.
+#define QLEEI__SYMBOL_NAME(zstr) { .data = zstr, .len = sizeof(zstr) - 1 }
+static const Qleei_String_View QLEEI_SYMBOL_NAMES[QLEEI_SYMBOL_KEYWORD_COUNT] = {
+  [QLEEI_SYMBOL_WHILE]   = QLEEI__SYMBOL_NAME("while"),
+  [QLEEI_SYMBOL_BEGIN]   = QLEEI__SYMBOL_NAME("begin"),
+  [QLEEI_SYMBOL_END]     = QLEEI__SYMBOL_NAME("end"),
+  [QLEEI_SYMBOL_PROC]    = QLEEI__SYMBOL_NAME("proc"),
+  [QLEEI_SYMBOL_TRUE]    = QLEEI__SYMBOL_NAME("true"),
+  [QLEEI_SYMBOL_FALSE]   = QLEEI__SYMBOL_NAME("false"),
+  [QLEEI_SYMBOL_NUMBER]  = QLEEI__SYMBOL_NAME("number"),
+  [QLEEI_SYMBOL_BOOL]    = QLEEI__SYMBOL_NAME("bool"),
+  [QLEEI_SYMBOL_POINTER] = QLEEI__SYMBOL_NAME("pointer"),
+  [QLEEI_SYMBOL_PTR]     = QLEEI__SYMBOL_NAME("ptr"),
+};
+#undef QLEEI__SYMBOL_NAME
 
-void qleei_lexer_init(QLeei_Lexer *l, const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
-  l->input_path = input_path;
-  l->buffer = buffer;
-  l->buffer_len = buf_size;
-  l->index = 0;
-  l->line = 1;
-  l->column = 1;
-  l->token = (QLeei_Token) { .string = { .data = buffer, .len = 0 } };
+// Id of the keyword spelled `name`, for lexers without a symbol table
+static qleei_ui32_t qleei__keyword_symbol(Qleei_String_View name) {
+  for (qleei_ui32_t id = QLEEI_SYMBOL_NONE + 1; id < QLEEI_SYMBOL_KEYWORD_COUNT; ++id) {
+    if (qleei_sv_eq_sv(name, QLEEI_SYMBOL_NAMES[id])) return id;
+  }
+  return QLEEI_SYMBOL_NONE;
 }
 
-bool qleei_lexer_next(QLeei_Lexer *lexer) {
-  lexer->token.loc.file_path = lexer->input_path;
-  lexer->token.kind = QLEEI_TOKEN_KIND_NONE;
-  if (lexer->buffer == NULL) {
-    qleei_printfn("[ERROR] Attempting to lex into a NULL buffer");
-    return false;
+static Qleei_String_View qleei__symbol_name(const Qleei_Symbols *symbols, const Qleei_Symbol *symbol) {
+  return (Qleei_String_View){ .data = symbols->names.items + symbol->name, .len = symbol->len };
+}
+
+// Slot holding `name`, or the free slot where it would go. The index always has a free slot
+static qleei_uisz_t qleei__symbols_slot(Qleei_Symbols *symbols, Qleei_String_View name, qleei_ui32_t hash) {
+  qleei_uisz_t mask = symbols->index.cap - 1;
+  qleei_uisz_t slot = hash & mask;
+  while (symbols->index.items[slot] != 0) {
+    Qleei_Symbol *symbol = &symbols->items[symbols->index.items[slot]];
+    if (symbol->hash == hash && qleei_sv_eq_sv(qleei__symbol_name(symbols, symbol), name)) break;
+    slot = (slot + 1) & mask;
   }
+  return slot;
+}
 
-  while (lexer->index < lexer->buffer_len) {
-    char c = lexer->buffer[lexer->index++];
-    while (qleei_is_space_char(c)) {
-      if (c == '\n') {
-	      lexer->line++;
-	      lexer->column = 1;
-      } else {
-	      lexer->column++;
-      }
-      if (lexer->index >= lexer->buffer_len) {
-        c = 0;
-        break;
+// Keeps at least half of the slots free, growing rehashes every symbol
+static bool qleei__symbols_index_grow(Qleei_Symbols *symbols) {
+  if ((symbols->index.len + 1)*2 <= symbols->index.cap) return true;
+  qleei_uisz_t cap = symbols->index.cap == 0 ? 64 : symbols->index.cap*2;
+  qleei_ui32_t *slots = qleei_mem_alloc(cap*sizeof(qleei_ui32_t));
+  if (slots == NULL) return false;
+  if (symbols->index.items != NULL) qleei_mem_free(symbols->index.items);
+  symbols->index.items = slots;
+  symbols->index.cap = cap;
+  for (qleei_uisz_t i = 0; i < cap; ++i) slots[i] = 0;
+  for (qleei_ui32_t id = QLEEI_SYMBOL_NONE + 1; id < symbols->len; ++id) {
+    Qleei_Symbol *symbol = &symbols->items[id];
+    slots[qleei__symbols_slot(symbols, qleei__symbol_name(symbols, symbol), symbol->hash)] = id;
+  }
+  return true;
+}
+
+static qleei_ui32_t qleei__symbols_add(Qleei_Symbols *symbols, Qleei_String_View name, qleei_ui32_t hash) {
+  if (!qleei__symbols_index_grow(symbols)) return QLEEI_SYMBOL_NONE;
+  if (!qleei_alist_reserve(&symbols->names, symbols->names.len + name.len)) return QLEEI_SYMBOL_NONE;
+  Qleei_Symbol symbol = { .name = symbols->names.len, .len = name.len, .hash = hash };
+  qleei_uisz_t builtin;
+  if (qleei__find_builtin_word(name, &builtin)) symbol.builtin = builtin + 1;
+  if (!qleei_alist_append(symbols, &symbol)) return QLEEI_SYMBOL_NONE;
+  qleei_mem_copy(symbols->names.items + symbols->names.len, name.data, name.len);
+  symbols->names.len += name.len;
+
+  qleei_ui32_t id = (qleei_ui32_t)(symbols->len - 1);
+  symbols->index.items[qleei__symbols_slot(symbols, name, hash)] = id;
+  symbols->index.len++;
+  return id;
+}
+
+qleei_ui32_t qleei_symbols_intern(Qleei_Symbols *symbols, Qleei_String_View name) {
+  if (symbols->len == 0) {
+    // The keywords come first so they get the ids of Qleei_Symbol_Id
+    Qleei_Symbol none = {0};
+    if (!qleei_alist_append(symbols, &none)) return QLEEI_SYMBOL_NONE;
+    for (qleei_ui32_t id = QLEEI_SYMBOL_NONE + 1; id < QLEEI_SYMBOL_KEYWORD_COUNT; ++id) {
+      Qleei_String_View keyword = QLEEI_SYMBOL_NAMES[id];
+      if (qleei__symbols_add(symbols, keyword, qleei__hash_sv(keyword, 0)) != id) {
+        qleei_symbols_free(symbols);
+        return QLEEI_SYMBOL_NONE;
       }
-      c = lexer->buffer[lexer->index++];
     }
+  }
 
-    // If somehow the last char is a null terminator we just ignore it
-    if (lexer->index >= lexer->buffer_len) {
-      if (c == 0) break;
-    }
+  qleei_ui32_t hash = qleei__hash_sv(name, 0);
+  qleei_ui32_t id = symbols->index.items[qleei__symbols_slot(symbols, name, hash)];
+  if (id != QLEEI_SYMBOL_NONE) return id;
+  return qleei__symbols_add(symbols, name, hash);
+}
 
-    // Ignore any unmanaged ASCII control character
-    if (c < 32) {
-      qleei_printfn("[WARN] Unexpected control character found in input: %d", (int)c);
-      continue;
-    }
+Qleei_String_View qleei_symbols_name(const Qleei_Symbols *symbols, qleei_ui32_t id) {
+  if (id == QLEEI_SYMBOL_NONE || id >= symbols->len) return (Qleei_String_View){0};
+  return qleei__symbol_name(symbols, &symbols->items[id]);
+}
 
-    QLeei_Token *token = &lexer->token;
-    token->loc.line = lexer->line;
-    token->loc.column = lexer->column;
-    QLeei_Lex_Location loc = token->loc;
+void qleei_symbols_free(Qleei_Symbols *symbols) {
+  qleei_alist_free(&symbols->index);
+  qleei_alist_free(&symbols->names);
+  qleei_alist_free(symbols);
+}
 
-    if (qleei_is_number_char(c)) {
-      token->string.data = lexer->buffer + (lexer->index - 1);
-      token->string.len = 0;
-      bool decimal = false;
-      while (qleei_is_number_char(c)) {
-	      lexer->column++;
-	      token->string.len++;
-        if (lexer->index >= lexer->buffer_len) break;
+// Symbol interned for identifier `t` with what it names now, NULL if it wasn't lexed with the interpreter's table
+static Qleei_Symbol *qleei__token_symbol(Qleei_Interpreter *it, const QLeei_Token *t) {
+  if (t->id == QLEEI_SYMBOL_NONE || t->id >= it->symbols.len) return NULL;
+  Qleei_Symbol *symbol = &it->symbols.items[t->id];
+  if (symbol->resolved != it->epoch + 1) {
+    Qleei_Custom_Word *word = qleei__custom_words_find(&it->words, t->string);
+    Qleei_Proc *proc = qleei_procs_find_by_sv_name(&it->procs, t->string);
+    symbol->word = word != NULL ? (qleei_uisz_t)(word - it->words.items) + 1 : 0;
+    symbol->proc = proc != NULL ? (qleei_uisz_t)(proc - it->procs.items) + 1 : 0;
+    symbol->resolved = it->epoch + 1;
+  }
+  return symbol;
+}
 
-	      c = lexer->buffer[lexer->index++];
-	      if (c == '.' && !decimal) {
-	        decimal = true;
-          if (lexer->index >= lexer->buffer_len) {
-            decimal = false;
-            break;
-          }
-	        c = lexer->buffer[lexer->index++];
-	      }
-      }
-      if (lexer->index < lexer->buffer_len) lexer->index -= 1;
-      token->kind = QLEEI_TOKEN_KIND_NUMBER;
-      token->number = qleei_parse_number(token->string);
-      return true;
-    }
+// Index of the builtin word named by identifier `t`, builtin words never change so they are looked up when interning
+static bool qleei__find_builtin_token(Qleei_Interpreter *it, const QLeei_Token *t, qleei_uisz_t *index) {
+  if (t->id == QLEEI_SYMBOL_NONE || t->id >= it->symbols.len) return qleei__find_builtin_word(t->string, index);
+  qleei_uisz_t builtin = it->symbols.items[t->id].builtin;
+  if (builtin == 0) return false;
+  *index = builtin - 1;
+  return true;
+}
 
-    if (qleei_is_identifier_start_char(c)) {
-      token->string.data = lexer->buffer + (lexer->index-1);
-      token->string.len = 0;
-      while (qleei_is_identifier_char(c)) {
-	      token->string.len++;
-        if (lexer->index >= lexer->buffer_len) break;
-	      c = lexer->buffer[lexer->index++];
-	      lexer->column++;
-      }
-      if (lexer->index < lexer->buffer_len) lexer->index -= 1;
+// Builtin or custom word named by identifier `t`, `NULL` if there is none
+static Qleei_Custom_Word *qleei__find_word(Qleei_Interpreter *it, const QLeei_Token *t) {
+  qleei_uisz_t index;
+  if (qleei__find_builtin_token(it, t, &index)) return &QLEEI_BUILTIN_WORDS[index];
+  Qleei_Symbol *symbol = qleei__token_symbol(it, t);
+  if (symbol == NULL) return qleei__custom_words_find(&it->words, t->string);
+  return symbol->word != 0 ? &it->words.items[symbol->word - 1] : NULL;
+}
 
-      if (qleei_sv_eq_zstr(token->string, "true")) {
-	      token->kind = QLEEI_TOKEN_KIND_BOOL;
-	      token->number = 1;
-      } else if (qleei_sv_eq_zstr(token->string, "false")) {
-	      token->kind = QLEEI_TOKEN_KIND_BOOL;
-	      token->number = 0;
-      } else {
-	      token->kind = QLEEI_TOKEN_KIND_IDENTIFIER;
-      }
+// Procedure named by identifier `t`, `NULL` if there is none
+static Qleei_Proc *qleei__find_proc(Qleei_Interpreter *it, const QLeei_Token *t) {
+  Qleei_Symbol *symbol = qleei__token_symbol(it, t);
+  if (symbol == NULL) return qleei_procs_find_by_sv_name(&it->procs, t->string);
+  return symbol->proc != 0 ? &it->procs.items[symbol->proc - 1] : NULL;
+}
 
-      return true;
-    }
+// ==================================================
+// Number parsing
+// --------------------------------------------------
+// Literals are parsed in place, the same way on every platform. Up to 19 significant digits are gathered into an
+// integer `w` and the rest only move the decimal exponent `e10`. Whole numbers up to 2^53 convert exactly, small
+// exponents take one exact multiplication or division (Clinger) and everything else goes through Eisel-Lemire: `w` is
+// multiplied by a 128 bit approximation of 10^e10 and the top 54 bits round to the result. The few inputs that land
+// too close to a halfway point are settled by comparing big integers, so every result is correctly rounded.
+#define QLEEI__NUMBER_MAX_DIGITS 800 // Significant digits compared exactly, the ones after only break ties
+#define QLEEI__BIG_WORDS 128         // 32 bit words in a big integer, enough for QLEEI__NUMBER_MAX_DIGITS
+
+#define QLEEI__POW5_MIN_EXP10 (-342)
+#define QLEEI__POW5_MAX_EXP10 308
+#define QLEEI__F64_INF_BITS 0x7FF0000000000000ULL
+
+// 10^e10 for e10 in [QLEEI__POW5_MIN_EXP10, QLEEI__POW5_MAX_EXP10] as {high, low} 64 bit halves of a 128 bit mantissa
+// with the top bit set. The powers of five are truncated, their inverses rounded up
+static const qleei_ui64_t QLEEI__POW10_128[QLEEI__POW5_MAX_EXP10 - QLEEI__POW5_MIN_EXP10 + 1][2] = {
+  {0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL}, // 1e-342
+  {0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL}, // 1e-341
+  {0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL}, // 1e-340
+  {0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL}, // 1e-339
+  {0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL}, // 1e-338
+  {0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL}, // 1e-337
+  {0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL}, // 1e-336
+  {0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL}, // 1e-335
+  {0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL}, // 1e-334
+  {0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL}, // 1e-333
+  {0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL}, // 1e-332
+  {0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL}, // 1e-331
+  {0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL}, // 1e-330
+  {0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL}, // 1e-329
+  {0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL}, // 1e-328
+  {0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL}, // 1e-327
+  {0x84A57695FE98746DULL, 0x014BB630F7604B57ULL}, // 1e-326
+  {0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL}, // 1e-325
+  {0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL}, // 1e-324
+  {0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL}, // 1e-323
+  {0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL}, // 1e-322
+  {0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL}, // 1e-321
+  {0xFD00B897478238D0ULL, 0x8920B098955522B4ULL}, // 1e-320
+  {0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL}, // 1e-319
+  {0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL}, // 1e-318
+  {0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL}, // 1e-317
+  {0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL}, // 1e-316
+  {0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL}, // 1e-315
+  {0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL}, // 1e-314
+  {0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL}, // 1e-313
+  {0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL}, // 1e-312
+  {0xEBA09271E88D976BULL, 0xF7864A44C633682EULL}, // 1e-311
+  {0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL}, // 1e-310
+  {0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL}, // 1e-309
+  {0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL}, // 1e-308
+  {0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL}, // 1e-307
+  {0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL}, // 1e-306
+  {0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL}, // 1e-305
+  {0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL}, // 1e-304
+  {0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL}, // 1e-303
+  {0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL}, // 1e-302
+  {0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL}, // 1e-301
+  {0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL}, // 1e-300
+  {0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL}, // 1e-299
+  {0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL}, // 1e-298
+  {0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL}, // 1e-297
+  {0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL}, // 1e-296
+  {0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL}, // 1e-295
+  {0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL}, // 1e-294
+  {0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL}, // 1e-293
+  {0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL}, // 1e-292
+  {0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL}, // 1e-291
+  {0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL}, // 1e-290
+  {0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL}, // 1e-289
+  {0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL}, // 1e-288
+  {0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL}, // 1e-287
+  {0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL}, // 1e-286
+  {0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL}, // 1e-285
+  {0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL}, // 1e-284
+  {0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL}, // 1e-283
+  {0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL}, // 1e-282
+  {0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL}, // 1e-281
+  {0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL}, // 1e-280
+  {0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL}, // 1e-279
+  {0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL}, // 1e-278
+  {0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL}, // 1e-277
+  {0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL}, // 1e-276
+  {0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL}, // 1e-275
+  {0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL}, // 1e-274
+  {0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL}, // 1e-273
+  {0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL}, // 1e-272
+  {0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL}, // 1e-271
+  {0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL}, // 1e-270
+  {0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL}, // 1e-269
+  {0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL}, // 1e-268
+  {0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL}, // 1e-267
+  {0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL}, // 1e-266
+  {0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL}, // 1e-265
+  {0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL}, // 1e-264
+  {0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL}, // 1e-263
+  {0xC987434744AC874EULL, 0xA327FFB266B56220ULL}, // 1e-262
+  {0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL}, // 1e-261
+  {0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL}, // 1e-260
+  {0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL}, // 1e-259
+  {0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL}, // 1e-258
+  {0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL}, // 1e-257
+  {0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL}, // 1e-256
+  {0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL}, // 1e-255
+  {0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL}, // 1e-254
+  {0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL}, // 1e-253
+  {0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL}, // 1e-252
+  {0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL}, // 1e-251
+  {0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL}, // 1e-250
+  {0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL}, // 1e-249
+  {0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL}, // 1e-248
+  {0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL}, // 1e-247
+  {0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL}, // 1e-246
+  {0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL}, // 1e-245
+  {0xAECC49914078536DULL, 0x58FAE9F773886E18ULL}, // 1e-244
+  {0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL}, // 1e-243
+  {0x888F99797A5E012DULL, 0x6D8406C952429603ULL}, // 1e-242
+  {0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL}, // 1e-241
+  {0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL}, // 1e-240
+  {0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL}, // 1e-239
+  {0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL}, // 1e-238
+  {0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL}, // 1e-237
+  {0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL}, // 1e-236
+  {0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL}, // 1e-235
+  {0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL}, // 1e-234
+  {0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL}, // 1e-233
+  {0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL}, // 1e-232
+  {0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL}, // 1e-231
+  {0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL}, // 1e-230
+  {0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL}, // 1e-229
+  {0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL}, // 1e-228
+  {0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL}, // 1e-227
+  {0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL}, // 1e-226
+  {0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL}, // 1e-225
+  {0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL}, // 1e-224
+  {0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL}, // 1e-223
+  {0xB913179899F68584ULL, 0x28E2557B59846E3FULL}, // 1e-222
+  {0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL}, // 1e-221
+  {0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL}, // 1e-220
+  {0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL}, // 1e-219
+  {0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL}, // 1e-218
+  {0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL}, // 1e-217
+  {0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL}, // 1e-216
+  {0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL}, // 1e-215
+  {0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL}, // 1e-214
+  {0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL}, // 1e-213
+  {0xD77485CB25823AC7ULL, 0x7D633293366B828BULL}, // 1e-212
+  {0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL}, // 1e-211
+  {0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL}, // 1e-210
+  {0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL}, // 1e-209
+  {0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL}, // 1e-208
+  {0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL}, // 1e-207
+  {0xCD795BE870516656ULL, 0x67902E276C921F8BULL}, // 1e-206
+  {0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL}, // 1e-205
+  {0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL}, // 1e-204
+  {0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL}, // 1e-203
+  {0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL}, // 1e-202
+  {0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL}, // 1e-201
+  {0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL}, // 1e-200
+  {0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL}, // 1e-199
+  {0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL}, // 1e-198
+  {0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL}, // 1e-197
+  {0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL}, // 1e-196
+  {0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL}, // 1e-195
+  {0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL}, // 1e-194
+  {0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL}, // 1e-193
+  {0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL}, // 1e-192
+  {0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL}, // 1e-191
+  {0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL}, // 1e-190
+  {0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL}, // 1e-189
+  {0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL}, // 1e-188
+  {0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL}, // 1e-187
+  {0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL}, // 1e-186
+  {0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL}, // 1e-185
+  {0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL}, // 1e-184
+  {0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL}, // 1e-183
+  {0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL}, // 1e-182
+  {0xD47487CC8470652BULL, 0x7647C3200069671FULL}, // 1e-181
+  {0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL}, // 1e-180
+  {0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL}, // 1e-179
+  {0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL}, // 1e-178
+  {0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL}, // 1e-177
+  {0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL}, // 1e-176
+  {0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL}, // 1e-175
+  {0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL}, // 1e-174
+  {0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL}, // 1e-173
+  {0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL}, // 1e-172
+  {0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL}, // 1e-171
+  {0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL}, // 1e-170
+  {0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL}, // 1e-169
+  {0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL}, // 1e-168
+  {0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL}, // 1e-167
+  {0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL}, // 1e-166
+  {0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL}, // 1e-165
+  {0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL}, // 1e-164
+  {0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL}, // 1e-163
+  {0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL}, // 1e-162
+  {0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL}, // 1e-161
+  {0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL}, // 1e-160
+  {0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL}, // 1e-159
+  {0x8C974F7383725573ULL, 0x1E414218C73A13FBULL}, // 1e-158
+  {0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL}, // 1e-157
+  {0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL}, // 1e-156
+  {0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL}, // 1e-155
+  {0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL}, // 1e-154
+  {0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL}, // 1e-153
+  {0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL}, // 1e-152
+  {0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL}, // 1e-151
+  {0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL}, // 1e-150
+  {0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL}, // 1e-149
+  {0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL}, // 1e-148
+  {0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL}, // 1e-147
+  {0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL}, // 1e-146
+  {0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL}, // 1e-145
+  {0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL}, // 1e-144
+  {0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL}, // 1e-143
+  {0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL}, // 1e-142
+  {0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL}, // 1e-141
+  {0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL}, // 1e-140
+  {0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL}, // 1e-139
+  {0xBE89523386091465ULL, 0xF6BBB397F1135823ULL}, // 1e-138
+  {0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL}, // 1e-137
+  {0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL}, // 1e-136
+  {0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL}, // 1e-135
+  {0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL}, // 1e-134
+  {0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL}, // 1e-133
+  {0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL}, // 1e-132
+  {0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL}, // 1e-131
+  {0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL}, // 1e-130
+  {0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL}, // 1e-129
+  {0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL}, // 1e-128
+  {0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL}, // 1e-127
+  {0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL}, // 1e-126
+  {0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL}, // 1e-125
+  {0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL}, // 1e-124
+  {0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL}, // 1e-123
+  {0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL}, // 1e-122
+  {0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL}, // 1e-121
+  {0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL}, // 1e-120
+  {0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL}, // 1e-119
+  {0x811CCC668829B887ULL, 0x0806357D5A3F525FULL}, // 1e-118
+  {0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL}, // 1e-117
+  {0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL}, // 1e-116
+  {0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL}, // 1e-115
+  {0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL}, // 1e-114
+  {0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL}, // 1e-113
+  {0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL}, // 1e-112
+  {0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL}, // 1e-111
+  {0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL}, // 1e-110
+  {0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL}, // 1e-109
+  {0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL}, // 1e-108
+  {0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL}, // 1e-107
+  {0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL}, // 1e-106
+  {0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL}, // 1e-105
+  {0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL}, // 1e-104
+  {0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL}, // 1e-103
+  {0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL}, // 1e-102
+  {0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL}, // 1e-101
+  {0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL}, // 1e-100
+  {0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL}, // 1e-99
+  {0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL}, // 1e-98
+  {0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL}, // 1e-97
+  {0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL}, // 1e-96
+  {0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL}, // 1e-95
+  {0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL}, // 1e-94
+  {0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL}, // 1e-93
+  {0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL}, // 1e-92
+  {0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL}, // 1e-91
+  {0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL}, // 1e-90
+  {0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL}, // 1e-89
+  {0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL}, // 1e-88
+  {0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL}, // 1e-87
+  {0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL}, // 1e-86
+  {0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL}, // 1e-85
+  {0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL}, // 1e-84
+  {0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL}, // 1e-83
+  {0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL}, // 1e-82
+  {0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL}, // 1e-81
+  {0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL}, // 1e-80
+  {0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL}, // 1e-79
+  {0xED246723473E3813ULL, 0x290123E9AAB23B68ULL}, // 1e-78
+  {0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL}, // 1e-77
+  {0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL}, // 1e-76
+  {0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL}, // 1e-75
+  {0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL}, // 1e-74
+  {0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL}, // 1e-73
+  {0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL}, // 1e-72
+  {0x8D590723948A535FULL, 0x579C487E5A38AD0EULL}, // 1e-71
+  {0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL}, // 1e-70
+  {0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL}, // 1e-69
+  {0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL}, // 1e-68
+  {0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL}, // 1e-67
+  {0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL}, // 1e-66
+  {0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL}, // 1e-65
+  {0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL}, // 1e-64
+  {0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL}, // 1e-63
+  {0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL}, // 1e-62
+  {0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL}, // 1e-61
+  {0xCDB02555653131B6ULL, 0x3792F412CB06794DULL}, // 1e-60
+  {0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL}, // 1e-59
+  {0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL}, // 1e-58
+  {0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL}, // 1e-57
+  {0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL}, // 1e-56
+  {0x9CED737BB6C4183DULL, 0x55464DD69685606BULL}, // 1e-55
+  {0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL}, // 1e-54
+  {0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL}, // 1e-53
+  {0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL}, // 1e-52
+  {0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL}, // 1e-51
+  {0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL}, // 1e-50
+  {0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL}, // 1e-49
+  {0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL}, // 1e-48
+  {0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL}, // 1e-47
+  {0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL}, // 1e-46
+  {0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL}, // 1e-45
+  {0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL}, // 1e-44
+  {0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL}, // 1e-43
+  {0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL}, // 1e-42
+  {0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL}, // 1e-41
+  {0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL}, // 1e-40
+  {0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL}, // 1e-39
+  {0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL}, // 1e-38
+  {0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL}, // 1e-37
+  {0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL}, // 1e-36
+  {0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL}, // 1e-35
+  {0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL}, // 1e-34
+  {0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL}, // 1e-33
+  {0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL}, // 1e-32
+  {0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL}, // 1e-31
+  {0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL}, // 1e-30
+  {0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL}, // 1e-29
+  {0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL}, // 1e-28
+  {0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL}, // 1e-27
+  {0xC612062576589DDAULL, 0x95364AFE032A819EULL}, // 1e-26
+  {0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL}, // 1e-25
+  {0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL}, // 1e-24
+  {0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL}, // 1e-23
+  {0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL}, // 1e-22
+  {0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL}, // 1e-21
+  {0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL}, // 1e-20
+  {0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL}, // 1e-19
+  {0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL}, // 1e-18
+  {0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL}, // 1e-17
+  {0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL}, // 1e-16
+  {0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL}, // 1e-15
+  {0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL}, // 1e-14
+  {0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL}, // 1e-13
+  {0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL}, // 1e-12
+  {0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL}, // 1e-11
+  {0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL}, // 1e-10
+  {0x89705F4136B4A597ULL, 0x31680A88F8953031ULL}, // 1e-9
+  {0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL}, // 1e-8
+  {0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL}, // 1e-7
+  {0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL}, // 1e-6
+  {0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL}, // 1e-5
+  {0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL}, // 1e-4
+  {0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL}, // 1e-3
+  {0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL}, // 1e-2
+  {0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL}, // 1e-1
+  {0x8000000000000000ULL, 0x0000000000000000ULL}, // 1e0
+  {0xA000000000000000ULL, 0x0000000000000000ULL}, // 1e1
+  {0xC800000000000000ULL, 0x0000000000000000ULL}, // 1e2
+  {0xFA00000000000000ULL, 0x0000000000000000ULL}, // 1e3
+  {0x9C40000000000000ULL, 0x0000000000000000ULL}, // 1e4
+  {0xC350000000000000ULL, 0x0000000000000000ULL}, // 1e5
+  {0xF424000000000000ULL, 0x0000000000000000ULL}, // 1e6
+  {0x9896800000000000ULL, 0x0000000000000000ULL}, // 1e7
+  {0xBEBC200000000000ULL, 0x0000000000000000ULL}, // 1e8
+  {0xEE6B280000000000ULL, 0x0000000000000000ULL}, // 1e9
+  {0x9502F90000000000ULL, 0x0000000000000000ULL}, // 1e10
+  {0xBA43B74000000000ULL, 0x0000000000000000ULL}, // 1e11
+  {0xE8D4A51000000000ULL, 0x0000000000000000ULL}, // 1e12
+  {0x9184E72A00000000ULL, 0x0000000000000000ULL}, // 1e13
+  {0xB5E620F480000000ULL, 0x0000000000000000ULL}, // 1e14
+  {0xE35FA931A0000000ULL, 0x0000000000000000ULL}, // 1e15
+  {0x8E1BC9BF04000000ULL, 0x0000000000000000ULL}, // 1e16
+  {0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL}, // 1e17
+  {0xDE0B6B3A76400000ULL, 0x0000000000000000ULL}, // 1e18
+  {0x8AC7230489E80000ULL, 0x0000000000000000ULL}, // 1e19
+  {0xAD78EBC5AC620000ULL, 0x0000000000000000ULL}, // 1e20
+  {0xD8D726B7177A8000ULL, 0x0000000000000000ULL}, // 1e21
+  {0x878678326EAC9000ULL, 0x0000000000000000ULL}, // 1e22
+  {0xA968163F0A57B400ULL, 0x0000000000000000ULL}, // 1e23
+  {0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL}, // 1e24
+  {0x84595161401484A0ULL, 0x0000000000000000ULL}, // 1e25
+  {0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL}, // 1e26
+  {0xCECB8F27F4200F3AULL, 0x0000000000000000ULL}, // 1e27
+  {0x813F3978F8940984ULL, 0x4000000000000000ULL}, // 1e28
+  {0xA18F07D736B90BE5ULL, 0x5000000000000000ULL}, // 1e29
+  {0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL}, // 1e30
+  {0xFC6F7C4045812296ULL, 0x4D00000000000000ULL}, // 1e31
+  {0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL}, // 1e32
+  {0xC5371912364CE305ULL, 0x6C28000000000000ULL}, // 1e33
+  {0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL}, // 1e34
+  {0x9A130B963A6C115CULL, 0x3C7F400000000000ULL}, // 1e35
+  {0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL}, // 1e36
+  {0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL}, // 1e37
+  {0x96769950B50D88F4ULL, 0x1314448000000000ULL}, // 1e38
+  {0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL}, // 1e39
+  {0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL}, // 1e40
+  {0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL}, // 1e41
+  {0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL}, // 1e42
+  {0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL}, // 1e43
+  {0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL}, // 1e44
+  {0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL}, // 1e45
+  {0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL}, // 1e46
+  {0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL}, // 1e47
+  {0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL}, // 1e48
+  {0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL}, // 1e49
+  {0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL}, // 1e50
+  {0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL}, // 1e51
+  {0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL}, // 1e52
+  {0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL}, // 1e53
+  {0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL}, // 1e54
+  {0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL}, // 1e55
+  {0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL}, // 1e56
+  {0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL}, // 1e57
+  {0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL}, // 1e58
+  {0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL}, // 1e59
+  {0x9F4F2726179A2245ULL, 0x01D762422C946590ULL}, // 1e60
+  {0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL}, // 1e61
+  {0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL}, // 1e62
+  {0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL}, // 1e63
+  {0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL}, // 1e64
+  {0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL}, // 1e65
+  {0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL}, // 1e66
+  {0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL}, // 1e67
+  {0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL}, // 1e68
+  {0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL}, // 1e69
+  {0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL}, // 1e70
+  {0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL}, // 1e71
+  {0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL}, // 1e72
+  {0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL}, // 1e73
+  {0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL}, // 1e74
+  {0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL}, // 1e75
+  {0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL}, // 1e76
+  {0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL}, // 1e77
+  {0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL}, // 1e78
+  {0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL}, // 1e79
+  {0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL}, // 1e80
+  {0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL}, // 1e81
+  {0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL}, // 1e82
+  {0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL}, // 1e83
+  {0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL}, // 1e84
+  {0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL}, // 1e85
+  {0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL}, // 1e86
+  {0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL}, // 1e87
+  {0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL}, // 1e88
+  {0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL}, // 1e89
+  {0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL}, // 1e90
+  {0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL}, // 1e91
+  {0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL}, // 1e92
+  {0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL}, // 1e93
+  {0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL}, // 1e94
+  {0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL}, // 1e95
+  {0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL}, // 1e96
+  {0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL}, // 1e97
+  {0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL}, // 1e98
+  {0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL}, // 1e99
+  {0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL}, // 1e100
+  {0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL}, // 1e101
+  {0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL}, // 1e102
+  {0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL}, // 1e103
+  {0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL}, // 1e104
+  {0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL}, // 1e105
+  {0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL}, // 1e106
+  {0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL}, // 1e107
+  {0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL}, // 1e108
+  {0x884134FE908658B2ULL, 0x3109058D147FDCDDULL}, // 1e109
+  {0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL}, // 1e110
+  {0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL}, // 1e111
+  {0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL}, // 1e112
+  {0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL}, // 1e113
+  {0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL}, // 1e114
+  {0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL}, // 1e115
+  {0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL}, // 1e116
+  {0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL}, // 1e117
+  {0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL}, // 1e118
+  {0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL}, // 1e119
+  {0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL}, // 1e120
+  {0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL}, // 1e121
+  {0x9AE757596946075FULL, 0x3375788DE9B06958ULL}, // 1e122
+  {0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL}, // 1e123
+  {0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL}, // 1e124
+  {0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL}, // 1e125
+  {0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL}, // 1e126
+  {0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL}, // 1e127
+  {0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL}, // 1e128
+  {0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL}, // 1e129
+  {0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL}, // 1e130
+  {0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL}, // 1e131
+  {0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL}, // 1e132
+  {0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL}, // 1e133
+  {0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL}, // 1e134
+  {0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL}, // 1e135
+  {0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL}, // 1e136
+  {0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL}, // 1e137
+  {0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL}, // 1e138
+  {0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL}, // 1e139
+  {0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL}, // 1e140
+  {0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL}, // 1e141
+  {0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL}, // 1e142
+  {0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL}, // 1e143
+  {0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL}, // 1e144
+  {0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL}, // 1e145
+  {0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL}, // 1e146
+  {0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL}, // 1e147
+  {0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL}, // 1e148
+  {0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL}, // 1e149
+  {0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL}, // 1e150
+  {0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL}, // 1e151
+  {0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL}, // 1e152
+  {0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL}, // 1e153
+  {0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL}, // 1e154
+  {0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL}, // 1e155
+  {0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL}, // 1e156
+  {0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL}, // 1e157
+  {0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL}, // 1e158
+  {0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL}, // 1e159
+  {0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL}, // 1e160
+  {0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL}, // 1e161
+  {0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL}, // 1e162
+  {0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL}, // 1e163
+  {0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL}, // 1e164
+  {0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL}, // 1e165
+  {0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL}, // 1e166
+  {0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL}, // 1e167
+  {0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL}, // 1e168
+  {0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL}, // 1e169
+  {0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL}, // 1e170
+  {0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL}, // 1e171
+  {0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL}, // 1e172
+  {0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL}, // 1e173
+  {0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL}, // 1e174
+  {0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL}, // 1e175
+  {0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL}, // 1e176
+  {0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL}, // 1e177
+  {0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL}, // 1e178
+  {0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL}, // 1e179
+  {0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL}, // 1e180
+  {0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL}, // 1e181
+  {0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL}, // 1e182
+  {0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL}, // 1e183
+  {0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL}, // 1e184
+  {0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL}, // 1e185
+  {0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL}, // 1e186
+  {0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL}, // 1e187
+  {0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL}, // 1e188
+  {0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL}, // 1e189
+  {0x8FA475791A569D10ULL, 0xF96E017D694487BCULL}, // 1e190
+  {0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL}, // 1e191
+  {0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL}, // 1e192
+  {0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL}, // 1e193
+  {0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL}, // 1e194
+  {0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL}, // 1e195
+  {0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL}, // 1e196
+  {0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL}, // 1e197
+  {0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL}, // 1e198
+  {0x85C7056562757456ULL, 0xF6872D5667844E49ULL}, // 1e199
+  {0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL}, // 1e200
+  {0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL}, // 1e201
+  {0x82A45B450226B39CULL, 0xECC0024661173473ULL}, // 1e202
+  {0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL}, // 1e203
+  {0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL}, // 1e204
+  {0xFF290242C83396CEULL, 0x7E67047175A15271ULL}, // 1e205
+  {0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL}, // 1e206
+  {0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL}, // 1e207
+  {0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL}, // 1e208
+  {0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL}, // 1e209
+  {0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL}, // 1e210
+  {0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL}, // 1e211
+  {0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL}, // 1e212
+  {0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL}, // 1e213
+  {0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL}, // 1e214
+  {0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL}, // 1e215
+  {0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL}, // 1e216
+  {0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL}, // 1e217
+  {0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL}, // 1e218
+  {0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL}, // 1e219
+  {0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL}, // 1e220
+  {0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL}, // 1e221
+  {0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL}, // 1e222
+  {0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL}, // 1e223
+  {0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL}, // 1e224
+  {0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL}, // 1e225
+  {0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL}, // 1e226
+  {0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL}, // 1e227
+  {0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL}, // 1e228
+  {0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL}, // 1e229
+  {0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL}, // 1e230
+  {0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL}, // 1e231
+  {0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL}, // 1e232
+  {0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL}, // 1e233
+  {0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL}, // 1e234
+  {0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL}, // 1e235
+  {0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL}, // 1e236
+  {0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL}, // 1e237
+  {0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL}, // 1e238
+  {0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL}, // 1e239
+  {0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL}, // 1e240
+  {0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL}, // 1e241
+  {0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL}, // 1e242
+  {0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL}, // 1e243
+  {0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL}, // 1e244
+  {0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL}, // 1e245
+  {0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL}, // 1e246
+  {0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL}, // 1e247
+  {0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL}, // 1e248
+  {0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL}, // 1e249
+  {0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL}, // 1e250
+  {0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL}, // 1e251
+  {0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL}, // 1e252
+  {0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL}, // 1e253
+  {0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL}, // 1e254
+  {0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL}, // 1e255
+  {0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL}, // 1e256
+  {0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL}, // 1e257
+  {0x8533285C936B35DEULL, 0xD53A88958F87275FULL}, // 1e258
+  {0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL}, // 1e259
+  {0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL}, // 1e260
+  {0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL}, // 1e261
+  {0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL}, // 1e262
+  {0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL}, // 1e263
+  {0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL}, // 1e264
+  {0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL}, // 1e265
+  {0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL}, // 1e266
+  {0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL}, // 1e267
+  {0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL}, // 1e268
+  {0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL}, // 1e269
+  {0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL}, // 1e270
+  {0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL}, // 1e271
+  {0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL}, // 1e272
+  {0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL}, // 1e273
+  {0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL}, // 1e274
+  {0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL}, // 1e275
+  {0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL}, // 1e276
+  {0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL}, // 1e277
+  {0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL}, // 1e278
+  {0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL}, // 1e279
+  {0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL}, // 1e280
+  {0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL}, // 1e281
+  {0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL}, // 1e282
+  {0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL}, // 1e283
+  {0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL}, // 1e284
+  {0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL}, // 1e285
+  {0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL}, // 1e286
+  {0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL}, // 1e287
+  {0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL}, // 1e288
+  {0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL}, // 1e289
+  {0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL}, // 1e290
+  {0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL}, // 1e291
+  {0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL}, // 1e292
+  {0xA0555E361951C366ULL, 0xD7E105BCC332621FULL}, // 1e293
+  {0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL}, // 1e294
+  {0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL}, // 1e295
+  {0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL}, // 1e296
+  {0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL}, // 1e297
+  {0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL}, // 1e298
+  {0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL}, // 1e299
+  {0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL}, // 1e300
+  {0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL}, // 1e301
+  {0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL}, // 1e302
+  {0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL}, // 1e303
+  {0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL}, // 1e304
+  {0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL}, // 1e305
+  {0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL}, // 1e306
+  {0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL}, // 1e307
+  {0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL}, // 1e308
+};
 
-    if (c == '\'') {
-      token->kind = QLEEI_TOKEN_KIND_NUMBER;
-      token->string.data = lexer->buffer + (lexer->index - 1);
-      token->string.len = 3;
+// Powers of ten a double holds exactly
+static const double QLEEI__POW10_EXACT[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
 
-      if (lexer->index >= lexer->buffer_len) {
-        qleei_loc_printfn(loc, "[LexError] Unterminated ASCII char literal");
-        return false;
-      }
-      lexer->column++;
-      loc.column++;
+static inline double qleei__f64_from_bits(qleei_ui64_t bits) {
+  union { qleei_ui64_t bits; double value; } u = { .bits = bits };
+  return u.value;
+}
+
+static inline qleei_ui64_t qleei__f64_to_bits(double value) {
+  union { double value; qleei_ui64_t bits; } u = { .value = value };
+  return u.bits;
+}
+
+// Full 128 bit product of `a` and `b`, returns the high half and stores the low one in `lo`
+static inline qleei_ui64_t qleei__mul_u64(qleei_ui64_t a, qleei_ui64_t b, qleei_ui64_t *lo) {
+#if defined(PLATFORM_DESKTOP) && defined(__SIZEOF_INT128__)
+  __extension__ unsigned __int128 p = (unsigned __int128)a * b;
+  *lo = (qleei_ui64_t)p;
+  return (qleei_ui64_t)(p >> 64);
+#else
+  // 32 bit x86 and wasm32 have no 128 bit integers without a runtime library
+  qleei_ui64_t a_lo = (qleei_ui32_t)a, a_hi = a >> 32;
+  qleei_ui64_t b_lo = (qleei_ui32_t)b, b_hi = b >> 32;
+  qleei_ui64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+  qleei_ui64_t mid = (ll >> 32) + (qleei_ui32_t)lh + (qleei_ui32_t)hl;
+  *lo = (mid << 32) | (qleei_ui32_t)ll;
+  return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// Bits of the double closest to w * 10^e10 (w > 0). Returns false when the product is too close to a halfway point to
+// decide or the result is subnormal, the caller falls back to qleei__number_slow then
+static bool qleei__eisel_lemire(qleei_ui64_t w, int e10, qleei_ui64_t *bits) {
+  if (e10 < QLEEI__POW5_MIN_EXP10) { *bits = 0; return true; }
+  if (e10 > QLEEI__POW5_MAX_EXP10) { *bits = QLEEI__F64_INF_BITS; return true; }
+  const qleei_ui64_t *pow10 = QLEEI__POW10_128[e10 - QLEEI__POW5_MIN_EXP10];
+
+  int clz = __builtin_clzll(w);
+  w <<= clz;
+  qleei_ui64_t exp2 = (qleei_ui64_t)(((qleei_si64_t)217706 * e10 >> 16) + 64 + 1023) - (qleei_ui64_t)clz;
+
+  qleei_ui64_t lo;
+  qleei_ui64_t hi = qleei__mul_u64(w, pow10[0], &lo);
+  // The truncated power can only be off in the bits below the 54 that are kept, unless they are all ones
+  if ((hi & 0x1FF) == 0x1FF && lo + w < w) {
+    qleei_ui64_t lo2;
+    qleei_ui64_t hi2 = qleei__mul_u64(w, pow10[1], &lo2);
+    qleei_ui64_t merged_hi = hi, merged_lo = lo + hi2;
+    if (merged_lo < lo) merged_hi++;
+    if ((merged_hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 && lo2 + w < w) return false;
+    hi = merged_hi;
+    lo = merged_lo;
+  }
+
+  qleei_ui64_t msb = hi >> 63;
+  qleei_ui64_t mantissa = hi >> (msb + 9);
+  exp2 -= 1 ^ msb;
+  if (lo == 0 && (hi & 0x1FF) == 0 && (mantissa & 3) == 1) return false;
+
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >> 53 > 0) {
+    mantissa >>= 1;
+    exp2 += 1;
+  }
+  if (exp2 - 1 >= 0x7FF - 1) return false;
+  *bits = exp2 << 52 | (mantissa & 0x000FFFFFFFFFFFFFULL);
+  return true;
+}
+
+// Unsigned integer of QLEEI__BIG_WORDS 32 bit words, least significant first
+typedef struct {
+  qleei_ui32_t words[QLEEI__BIG_WORDS];
+  qleei_uisz_t len;
+} Qleei__Big;
+
+static void qleei__big_mul_add(Qleei__Big *b, qleei_ui32_t mul, qleei_ui32_t add) {
+  qleei_ui64_t carry = add;
+  for (qleei_uisz_t i = 0; i < b->len; ++i) {
+    carry += (qleei_ui64_t)b->words[i] * mul;
+    b->words[i] = (qleei_ui32_t)carry;
+    carry >>= 32;
+  }
+  if (carry != 0 && b->len < QLEEI__BIG_WORDS) b->words[b->len++] = (qleei_ui32_t)carry;
+}
+
+static void qleei__big_mul_pow5(Qleei__Big *b, int n) {
+  for (; n >= 13; n -= 13) qleei__big_mul_add(b, 1220703125, 0);
+  qleei_ui32_t rest = 1;
+  while (n-- > 0) rest *= 5;
+  qleei__big_mul_add(b, rest, 0);
+}
+
+static void qleei__big_shl(Qleei__Big *b, int n) {
+  qleei_uisz_t words = (qleei_uisz_t)n / 32;
+  int bits = n % 32;
+  if (b->len == 0 || b->len + words + 1 > QLEEI__BIG_WORDS) return;
+  b->words[b->len + words] = 0;
+  for (qleei_uisz_t i = b->len; i-- > 0;) {
+    if (bits != 0) b->words[i + words + 1] |= b->words[i] >> (32 - bits);
+    b->words[i + words] = b->words[i] << bits;
+  }
+  for (qleei_uisz_t i = 0; i < words; ++i) b->words[i] = 0;
+  b->len += words + 1;
+  while (b->len > 0 && b->words[b->len - 1] == 0) b->len--;
+}
+
+static int qleei__big_cmp(const Qleei__Big *a, const Qleei__Big *b) {
+  if (a->len != b->len) return a->len < b->len ? -1 : 1;
+  for (qleei_uisz_t i = a->len; i-- > 0;) {
+    if (a->words[i] != b->words[i]) return a->words[i] < b->words[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+// Compares digits * 10^e10, plus something below one unit of the last digit when `sticky`, with the point halfway
+// between the double with `bits` and the next one up
+static int qleei__number_cmp_halfway(const Qleei__Big *digits, int e10, bool sticky, qleei_ui64_t bits) {
+  qleei_ui64_t biased = bits >> 52;
+  qleei_ui64_t mantissa = bits & 0x000FFFFFFFFFFFFFULL;
+  if (biased != 0) mantissa |= 1ULL << 52;
+  int exp2 = (biased != 0 ? (int)biased : 1) - 1075;
+
+  Qleei__Big lhs = *digits;
+  Qleei__Big rhs = { .words = { (qleei_ui32_t)(2*mantissa + 1), (qleei_ui32_t)((2*mantissa + 1) >> 32) }, .len = 2 };
+  if (e10 >= 0) qleei__big_mul_pow5(&lhs, e10);
+  else          qleei__big_mul_pow5(&rhs, -e10);
+  int shift = e10 - (exp2 - 1);
+  if (shift >= 0) qleei__big_shl(&lhs, shift);
+  else            qleei__big_shl(&rhs, -shift);
+
+  int cmp = qleei__big_cmp(&lhs, &rhs);
+  if (cmp == 0 && sticky) cmp = 1;
+  return cmp;
+}
+
+// Bits of the double closest to the digits of `mantissa` (leading zeros and the decimal point are skipped) times
+// 10^exp10, where `exp10` is only the exponent written after 'e'. The search starts from `guess`, which has to be within
+// a few units in the last place
+static qleei_ui64_t qleei__number_slow(Qleei_String_View mantissa, int exp10, qleei_ui64_t guess) {
+  Qleei__Big digits = {0};
+  qleei_ui32_t chunk = 0, chunk_scale = 1;
+  int count = 0, e10 = exp10;
+  bool fraction = false, sticky = false;
+  for (qleei_uisz_t i = 0; i < mantissa.len; ++i) {
+    char c = mantissa.data[i];
+    if (c == '.') { fraction = true; continue; }
+    if (count == 0 && c == '0') {
+      if (fraction) e10--;
+      continue;
+    }
+    if (count < QLEEI__NUMBER_MAX_DIGITS) {
+      chunk = chunk*10 + (qleei_ui32_t)(c - '0');
+      chunk_scale *= 10;
+      if (chunk_scale == 1000000000) {
+        qleei__big_mul_add(&digits, chunk_scale, chunk);
+        chunk = 0;
+        chunk_scale = 1;
+      }
+      count++;
+      if (fraction) e10--;
+    } else {
+      if (c != '0') sticky = true;
+      if (!fraction) e10++;
+    }
+  }
+  qleei__big_mul_add(&digits, chunk_scale, chunk);
+
+  qleei_ui64_t bits = guess;
+  for (;;) {
+    if (bits < QLEEI__F64_INF_BITS) {
+      int cmp = qleei__number_cmp_halfway(&digits, e10, sticky, bits);
+      if (cmp > 0 || (cmp == 0 && (bits & 1))) { bits++; continue; }
+    }
+    if (bits > 0) {
+      int cmp = qleei__number_cmp_halfway(&digits, e10, sticky, bits - 1);
+      if (cmp < 0 || (cmp == 0 && !((bits - 1) & 1))) { bits--; continue; }
+    }
+    return bits;
+  }
+}
+
+double qleei_parse_number(Qleei_String_View sv) {
+  qleei_uisz_t i = 0;
+  bool negative = false;
+  if (i < sv.len && (sv.data[i] == '-' || sv.data[i] == '+')) negative = sv.data[i++] == '-';
+
+  Qleei_String_View mantissa = { .data = sv.data + i, .len = 0 };
+  qleei_ui64_t w = 0;
+  int count = 0, e10 = 0, exp = 0;
+  bool fraction = false, truncated = false, any_digit = false;
+  for (; i < sv.len; ++i) {
+    char c = sv.data[i];
+    if (c == '.' && !fraction) { fraction = true; continue; }
+    if (!qleei_is_number_char(c)) break;
+    any_digit = true;
+    if (count == 0 && c == '0') {
+      if (fraction) e10--;
+      continue;
+    }
+    if (count < 19) {
+      w = w*10 + (qleei_ui64_t)(c - '0');
+      if (fraction) e10--;
+    } else {
+      if (c != '0') truncated = true;
+      if (!fraction) e10++;
+    }
+    count++;
+  }
+  if (!any_digit) return 0.0;
+  mantissa.len = (sv.data + i) - mantissa.data;
+
+  if (i + 1 < sv.len && (sv.data[i] == 'e' || sv.data[i] == 'E')) {
+    qleei_uisz_t j = i + 1;
+    bool exp_negative = false;
+    if (sv.data[j] == '-' || sv.data[j] == '+') exp_negative = sv.data[j++] == '-';
+    for (; j < sv.len && qleei_is_number_char(sv.data[j]); ++j) {
+      if (exp < 100000) exp = exp*10 + (sv.data[j] - '0');
+    }
+    if (exp_negative) exp = -exp;
+    e10 += exp;
+  }
+
+  if (w == 0) return negative ? -0.0 : 0.0;
+
+  if (!truncated && w <= (1ULL << 53)) {
+    if (e10 == 0) return negative ? -(double)w : (double)w;
+#if defined(__FLT_EVAL_METHOD__) && (__FLT_EVAL_METHOD__ == 0 || __FLT_EVAL_METHOD__ == 1)
+    // Both operands are exact so the one rounding is the correct one, x87 would round twice
+    if (-22 <= e10 && e10 <= 22) {
+      double value = e10 < 0 ? (double)w / QLEEI__POW10_EXACT[-e10] : (double)w * QLEEI__POW10_EXACT[e10];
+      return negative ? -value : value;
+    }
+#endif
+  }
+
+  qleei_ui64_t bits;
+  bool found = qleei__eisel_lemire(w, e10, &bits);
+  if (found && truncated) {
+    // The digits that did not fit put the value between w and w + 1, both have to round the same way
+    qleei_ui64_t above;
+    found = qleei__eisel_lemire(w + 1, e10, &above) && above == bits;
+  }
+  if (!found) {
+    double guess = (double)w;
+    int scale = e10;
+    for (; scale > 22; scale -= 22) guess *= 1e22;
+    for (; scale < -22; scale += 22) guess /= 1e22;
+    guess = scale < 0 ? guess / QLEEI__POW10_EXACT[-scale] : guess * QLEEI__POW10_EXACT[scale];
+    bits = qleei__number_slow(mantissa, exp, qleei__f64_to_bits(guess));
+  }
+  return qleei__f64_from_bits(bits | (negative ? 1ULL << 63 : 0));
+}
+
+// ==================================================
+// Lexer scanning
+// --------------------------------------------------
+// Whitespace and the inside of `//` comments are skipped a whole vector at a time: a block is compared against the
+// bytes that end the run and the index of the first match comes from its bit mask. The bytes left after the last full
+// block go through the scalar loop. `-DQLEEI_DISABLE_SIMD` keeps only the scalar loop.
+#if !defined(QLEEI_DISABLE_SIMD) && defined(PLATFORM_DESKTOP) && defined(__AVX2__)
+#  include <immintrin.h>
+#  define QLEEI_SCAN_WIDTH 32
+
+static inline qleei_ui32_t qleei__scan_not_blank_mask(const char *p) {
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                                  _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                                  _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                                                  _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+  return ~(qleei_ui32_t)_mm256_movemask_epi8(blank);
+}
+
+static inline qleei_ui32_t qleei__scan_newline_mask(const char *p) {
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  return (qleei_ui32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+}
+#elif !defined(QLEEI_DISABLE_SIMD) && defined(PLATFORM_DESKTOP) && defined(__SSE2__)
+#  include <emmintrin.h>
+#  define QLEEI_SCAN_WIDTH 16
+
+static inline qleei_ui32_t qleei__scan_not_blank_mask(const char *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                            _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                               _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                                            _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+  return ~(qleei_ui32_t)_mm_movemask_epi8(blank) & 0xFFFF;
+}
+
+static inline qleei_ui32_t qleei__scan_newline_mask(const char *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  return (qleei_ui32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+}
+#elif !defined(QLEEI_DISABLE_SIMD) && defined(PLATFORM_BROWSER) && defined(__wasm_simd128__)
+// Browser builds have no headers, clang's vector extensions lower to SIMD128 instructions
+#  define QLEEI_SCAN_WIDTH 16
+typedef signed char qleei__i8x16 __attribute__((vector_size(16)));
+typedef signed char qleei__i8x16_unaligned __attribute__((vector_size(16), aligned(1)));
+
+static inline qleei_ui32_t qleei__scan_not_blank_mask(const char *p) {
+  qleei__i8x16 v = *(const qleei__i8x16_unaligned *)p;
+  qleei__i8x16 blank = (v == ' ') | (v == '\t') | (v == '\r') | (v == '\n');
+  return ~(qleei_ui32_t)__builtin_wasm_bitmask_i8x16(blank) & 0xFFFF;
+}
+
+static inline qleei_ui32_t qleei__scan_newline_mask(const char *p) {
+  qleei__i8x16 v = *(const qleei__i8x16_unaligned *)p;
+  return (qleei_ui32_t)__builtin_wasm_bitmask_i8x16(v == '\n');
+}
+#endif
+
+// Index of the first byte from `i` on that is not whitespace, `len` if there is none
+static qleei_uisz_t qleei__scan_blank(const char *buffer, qleei_uisz_t i, qleei_uisz_t len) {
+#ifdef QLEEI_SCAN_WIDTH
+  for (; i + QLEEI_SCAN_WIDTH <= len; i += QLEEI_SCAN_WIDTH) {
+    qleei_ui32_t stops = qleei__scan_not_blank_mask(buffer + i);
+    if (stops != 0) return i + __builtin_ctz(stops);
+  }
+#endif // QLEEI_SCAN_WIDTH
+  while (i < len && qleei_is_space_char(buffer[i])) i++;
+  return i;
+}
+
+// Index of the first newline from `i` on, `len` if there is none
+static qleei_uisz_t qleei__scan_line_end(const char *buffer, qleei_uisz_t i, qleei_uisz_t len) {
+#ifdef QLEEI_SCAN_WIDTH
+  for (; i + QLEEI_SCAN_WIDTH <= len; i += QLEEI_SCAN_WIDTH) {
+    qleei_ui32_t stops = qleei__scan_newline_mask(buffer + i);
+    if (stops != 0) return i + __builtin_ctz(stops);
+  }
+#endif // QLEEI_SCAN_WIDTH
+  while (i < len && buffer[i] != '\n') i++;
+  return i;
+}
+
+// Records the starts of the lines of `buffer` up to `index`, `false` if they couldn't all be recorded
+static bool qleei__line_starts_record(Qleei_Line_Starts *lines, const char *buffer, qleei_uisz_t index) {
+  if (lines->buffer != buffer) {
+    lines->buffer = buffer;
+    lines->scanned = 0;
+    lines->len = 0;
+    qleei_uisz_t first = 0;
+    if (!qleei_alist_append(lines, &first)) {
+      lines->buffer = NULL;
+      return false;
+    }
+  }
+  while (lines->scanned < index) {
+    qleei_uisz_t end = qleei__scan_line_end(buffer, lines->scanned, index);
+    if (end == index) {
+      lines->scanned = end;
+      break;
+    }
+    qleei_uisz_t start = end + 1;
+    if (!qleei_alist_append(lines, &start)) return false;
+    lines->scanned = start;
+  }
+  return true;
+}
+
+// A buffer compiled again may hold new contents
+static void qleei__line_starts_forget(Qleei_Line_Starts *lines) {
+  lines->buffer = NULL;
+  lines->scanned = 0;
+  lines->len = 0;
+}
+
+void qleei_loc_line_column(QLeei_Lex_Location loc, qleei_uisz_t *line, qleei_uisz_t *column) {
+  *line = 0;
+  *column = 0;
+  if (loc.buffer == NULL) return;
+
+  if (loc.lines == NULL || !qleei__line_starts_record(loc.lines, loc.buffer, loc.index)) {
+    qleei_uisz_t lines_before = 0, start = 0;
+    while (true) {
+      qleei_uisz_t end = qleei__scan_line_end(loc.buffer, start, loc.index);
+      if (end == loc.index) break;
+      start = end + 1;
+      lines_before++;
+    }
+    *line = loc.line_base + lines_before + 1;
+    *column = loc.index - start + 1;
+    return;
+  }
+
+  // Last line starting at or before the location
+  Qleei_Line_Starts *lines = loc.lines;
+  qleei_uisz_t lo = 0, hi = lines->len;
+  while (hi - lo > 1) {
+    qleei_uisz_t mid = lo + (hi - lo)/2;
+    if (lines->items[mid] <= loc.index) lo = mid;
+    else                                hi = mid;
+  }
+  *line = loc.line_base + lo + 1;
+  *column = loc.index - lines->items[lo] + 1;
+}
+
+void qleei_lexer_init(QLeei_Lexer *l, const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
+  l->input_path = input_path;
+  l->buffer = buffer;
+  l->buffer_len = buf_size;
+  l->index = 0;
+  l->line_base = 0;
+  l->tokens = NULL;
+  l->cursor = 0;
+  l->symbols = NULL;
+  l->lines = NULL;
+  l->token = (QLeei_Token) { .string = { .data = buffer, .len = 0 } };
+}
+
+void qleei_lexer_init_tokens(QLeei_Lexer *l, const char *input_path, const char *buffer, qleei_uisz_t buf_size, const Qleei_Tokens *tokens) {
+  qleei_lexer_init(l, input_path, buffer, buf_size);
+  l->tokens = tokens;
+}
+
+// qleei_lexer_next for lexers initialized with qleei_lexer_init_tokens
+static bool qleei__lexer_replay(QLeei_Lexer *l) {
+  const Qleei_Tokens *tokens = l->tokens;
+  QLeei_Token *token = &l->token;
+  if (l->cursor >= tokens->len) {
+    l->index = l->buffer_len;
+    token->kind = QLEEI_TOKEN_KIND_EOF;
+    return true;
+  }
+
+  qleei_uisz_t i = l->cursor++;
+  token->kind = (Qleei_Token_Kind)tokens->kinds[i];
+  token->loc.index = tokens->offsets[i];
+  token->string.data = l->buffer + tokens->offsets[i];
+  token->string.len = tokens->lengths[i];
+  token->number = tokens->numbers[i];
+  token->symbol = token->kind == QLEEI_TOKEN_KIND_SYMBOL && token->string.len == 1 ? (qleei_ui8_t)token->string.data[0] : 0;
+  token->id = tokens->ids[i];
+  l->index = tokens->offsets[i] + tokens->lengths[i];
+  return true;
+}
+
+static bool qleei__tokens_reserve(Qleei_Tokens *tokens, qleei_uisz_t count) {
+  if (count <= tokens->cap) return true;
+  qleei_uisz_t cap = tokens->cap == 0 ? 256 : tokens->cap;
+  while (count > cap) cap *= 2;
+
+  qleei_ui8_t  *kinds   = qleei_mem_realloc(tokens->kinds,   cap*sizeof(*tokens->kinds));
+  if (kinds != NULL) tokens->kinds = kinds;
+  qleei_ui32_t *offsets = qleei_mem_realloc(tokens->offsets, cap*sizeof(*tokens->offsets));
+  if (offsets != NULL) tokens->offsets = offsets;
+  qleei_ui32_t *lengths = qleei_mem_realloc(tokens->lengths, cap*sizeof(*tokens->lengths));
+  if (lengths != NULL) tokens->lengths = lengths;
+  double       *numbers = qleei_mem_realloc(tokens->numbers, cap*sizeof(*tokens->numbers));
+  if (numbers != NULL) tokens->numbers = numbers;
+  qleei_ui32_t *ids     = qleei_mem_realloc(tokens->ids,     cap*sizeof(*tokens->ids));
+  if (ids != NULL) tokens->ids = ids;
+  if (kinds == NULL || offsets == NULL || lengths == NULL || numbers == NULL || ids == NULL) return false;
+
+  tokens->cap = cap;
+  return true;
+}
+
+static bool qleei__tokens_append(Qleei_Tokens *tokens, const char *buffer, const QLeei_Token *t) {
+  if (!qleei__tokens_reserve(tokens, tokens->len + 1)) return false;
+
+  qleei_uisz_t i = tokens->len++;
+  bool valued = t->kind == QLEEI_TOKEN_KIND_NUMBER || t->kind == QLEEI_TOKEN_KIND_BOOL;
+  tokens->kinds[i]   = (qleei_ui8_t)t->kind;
+  tokens->offsets[i] = (qleei_ui32_t)(t->string.data - buffer);
+  tokens->lengths[i] = (qleei_ui32_t)t->string.len;
+  tokens->numbers[i] = valued ? t->number : 0;
+  tokens->ids[i]     = t->id;
+  return true;
+}
+
+// Lexes what is left of `l`'s buffer into `tokens`
+static bool qleei__tokenize_lexer(Qleei_Tokens *tokens, QLeei_Lexer l) {
+  tokens->len = 0;
+  if (l.buffer_len > (qleei_ui32_t)-1) {
+    qleei_printfn("[ERROR] Input of %zu bytes is too large to tokenize", l.buffer_len);
+    return false;
+  }
+
+  while (true) {
+    if (!qleei_lexer_next(&l)) return false;
+    if (l.token.kind == QLEEI_TOKEN_KIND_EOF) return true;
+    if (!qleei__tokens_append(tokens, l.buffer, &l.token)) return false;
+  }
+}
+
+bool qleei_tokenize(Qleei_Tokens *tokens, const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
+  QLeei_Lexer l;
+  qleei_lexer_init(&l, input_path, buffer, buf_size);
+  return qleei__tokenize_lexer(tokens, l);
+}
+
+void qleei_tokens_free(Qleei_Tokens *tokens) {
+  if (tokens->kinds   != NULL) qleei_mem_free(tokens->kinds);
+  if (tokens->offsets != NULL) qleei_mem_free(tokens->offsets);
+  if (tokens->lengths != NULL) qleei_mem_free(tokens->lengths);
+  if (tokens->numbers != NULL) qleei_mem_free(tokens->numbers);
+  if (tokens->ids     != NULL) qleei_mem_free(tokens->ids);
+  *tokens = (Qleei_Tokens){0};
+}
+
+bool qleei_lexer_next(QLeei_Lexer *lexer) {
+  lexer->token.loc.file_path = lexer->input_path;
+  lexer->token.loc.buffer = lexer->buffer;
+  lexer->token.loc.line_base = lexer->line_base;
+  lexer->token.loc.lines = lexer->lines;
+  lexer->token.kind = QLEEI_TOKEN_KIND_NONE;
+  lexer->token.symbol = 0;
+  lexer->token.id = QLEEI_SYMBOL_NONE;
+  if (lexer->buffer == NULL) {
+    qleei_printfn("[ERROR] Attempting to lex into a NULL buffer");
+    return false;
+  }
+  if (lexer->tokens != NULL) return qleei__lexer_replay(lexer);
+
+  while (lexer->index < lexer->buffer_len) {
+    lexer->index = qleei__scan_blank(lexer->buffer, lexer->index, lexer->buffer_len);
+    if (lexer->index >= lexer->buffer_len) break;
+
+    char c = lexer->buffer[lexer->index++];
+
+    // If somehow the last char is a null terminator we just ignore it
+    if (lexer->index >= lexer->buffer_len) {
+      if (c == 0) break;
+    }
+
+    // Ignore any unmanaged ASCII control character
+    if (c < 32) {
+      qleei_printfn("[WARN] Unexpected control character found in input: %d", (int)c);
+      continue;
+    }
+
+    QLeei_Token *token = &lexer->token;
+    token->loc.index = lexer->index - 1;
+    QLeei_Lex_Location loc = token->loc;
+
+    if (qleei_is_number_char(c)) {
+      token->string.data = lexer->buffer + (lexer->index - 1);
+      token->string.len = 0;
+      bool decimal = false;
+      while (qleei_is_number_char(c)) {
+	      token->string.len++;
+        if (lexer->index >= lexer->buffer_len) break;
+
+	      c = lexer->buffer[lexer->index++];
+	      if (c == '.' && !decimal) {
+	        decimal = true;
+	        token->string.len++;
+          if (lexer->index >= lexer->buffer_len) {
+            decimal = false;
+            break;
+          }
+	        c = lexer->buffer[lexer->index++];
+	      }
+      }
+      if (lexer->index < lexer->buffer_len) lexer->index -= 1;
+      token->kind = QLEEI_TOKEN_KIND_NUMBER;
+      token->number = qleei_parse_number(token->string);
+      return true;
+    }
+
+    if (qleei_is_identifier_start_char(c)) {
+      token->string.data = lexer->buffer + (lexer->index-1);
+      token->string.len = 0;
+      while (qleei_is_identifier_char(c)) {
+	      token->string.len++;
+        if (lexer->index >= lexer->buffer_len) break;
+	      c = lexer->buffer[lexer->index++];
+      }
+      if (lexer->index < lexer->buffer_len) lexer->index -= 1;
+
+      if (lexer->symbols != NULL) token->id = qleei_symbols_intern(lexer->symbols, token->string);
+      if (token->id == QLEEI_SYMBOL_NONE) token->id = qleei__keyword_symbol(token->string);
+
+      if (token->id == QLEEI_SYMBOL_TRUE) {
+	      token->kind = QLEEI_TOKEN_KIND_BOOL;
+	      token->number = 1;
+      } else if (token->id == QLEEI_SYMBOL_FALSE) {
+	      token->kind = QLEEI_TOKEN_KIND_BOOL;
+	      token->number = 0;
+      } else {
+	      token->kind = QLEEI_TOKEN_KIND_IDENTIFIER;
+      }
+
+      return true;
+    }
+
+    if (c == '\'') {
+      token->kind = QLEEI_TOKEN_KIND_NUMBER;
+      token->string.data = lexer->buffer + (lexer->index - 1);
+      token->string.len = 3;
+
+      if (lexer->index >= lexer->buffer_len) {
+        qleei_loc_printfn(loc, "[LexError] Unterminated ASCII char literal");
+        return false;
+      }
+      loc.index++;
 
       c = lexer->buffer[lexer->index++];
       token->number = (double)c;
@@ -1446,26 +3687,22 @@ bool qleei_lexer_next(QLeei_Lexer *lexer) {
         return false;
       }
 
-      loc.column++;
-      lexer->column++;
+      loc.index++;
       c = lexer->buffer[lexer->index++];
       if (c != '\'') {
         qleei_loc_printfn(loc, "[LexError] ASCII char literal does not end with ' or takes more than 1 byte");
         return false;
       }
-      lexer->column++;
       return true;
     }
 
     token->kind = QLEEI_TOKEN_KIND_SYMBOL;
     token->string.data = lexer->buffer + (lexer->index - 1);
     token->string.len = 1;
-    lexer->column++;
 
     if (c == '-') {
       if (lexer->index < lexer->buffer_len && lexer->buffer[lexer->index] == '>') {
 	      lexer->index++;
-	      lexer->column++;
 	      token->string.len = 2;
 	      return true;
       }
@@ -1473,14 +3710,12 @@ bool qleei_lexer_next(QLeei_Lexer *lexer) {
 
     if (*(lexer->buffer + (lexer->index - 1)) == '/') {
       if (lexer->buffer_len > lexer->index && lexer->buffer[lexer->index] == '/') {
-	      while (lexer->index < lexer->buffer_len && lexer->buffer[lexer->index] != '\n') {
-	        lexer->column++;
-	        lexer->index++;
-	      }
+	      lexer->index = qleei__scan_line_end(lexer->buffer, lexer->index, lexer->buffer_len);
 	      continue;
       }
     }
 
+    token->symbol = (qleei_ui8_t)c;
     return true;
   }
 
@@ -1498,9 +3733,9 @@ bool qleei_lexer_peek(QLeei_Lexer *l, QLeei_Token *t) {
 QLeei_Lex_Location qleei_lexer_save_point(QLeei_Lexer *l) {
   QLeei_Lex_Location save_point = {
     .file_path = l->input_path,
+    .buffer = l->buffer,
     .index = l->index,
-    .line = l->line,
-    .column = l->column,
+    .line_base = l->line_base,
   };
   return save_point;
 }
@@ -1508,8 +3743,16 @@ QLeei_Lex_Location qleei_lexer_save_point(QLeei_Lexer *l) {
 bool qleei_lexer_restore_point(QLeei_Lexer *l, QLeei_Lex_Location save_point) {
   l->input_path = save_point.file_path;
   l->index = save_point.index;
-  l->line = save_point.line;
-  l->column = save_point.column;
+  if (l->tokens != NULL) {
+    // Replay from the first token at or after the saved index
+    qleei_uisz_t lo = 0, hi = l->tokens->len;
+    while (lo < hi) {
+      qleei_uisz_t mid = lo + (hi - lo)/2;
+      if (l->tokens->offsets[mid] < save_point.index) lo = mid + 1;
+      else                                            hi = mid;
+    }
+    l->cursor = lo;
+  }
   return true;
 }
 
@@ -1520,18 +3763,18 @@ void qleei_print_stack(Qleei_Stack *s) {
     qleei_uisz_t index = s->len - (i + 1);
     Qleei_Value_Item item = s->items[index];
     if (i > 0) qleei_printf(", ");
-    switch (item.kind) {
+    switch (qleei_value_item_kind(item)) {
     case QLEEI_VALUE_KIND_NUMBER:
-      qleei_printf("Number(%.4f)", item.as_number.value);
+      qleei_printf("Number(%.4f)", qleei_value_item_number(item));
       break;
     case QLEEI_VALUE_KIND_BOOL:
-      qleei_printf("Bool(%s)", item.as_bool.value ? "true" : "false");
+      qleei_printf("Bool(%s)", qleei_value_item_bool(item) ? "true" : "false");
       break;
     case QLEEI_VALUE_KIND_POINTER:
-      qleei_printf("Pointer(%p)", item.as_pointer.value);
+      qleei_printf("Pointer(%p)", qleei_value_item_pointer(item));
       break;
     default:
-      qleei_printf("CorruptedValue(%d, %.4f)", item.kind, item.as_number.value);
+      qleei_printf("CorruptedValue(%d, %.4f)", qleei_value_item_kind(item), qleei_value_item_number(item));
       break;
     }
   }
@@ -1560,119 +3803,706 @@ bool qleei_action_expects_value_kind(QLeei_Lex_Location loc, Qleei_String_View s
 
 
 double qleei_value_item_as_number(Qleei_Value_Item item) {
-  switch (item.kind) {
+  switch (qleei_value_item_kind(item)) {
   case QLEEI_VALUE_KIND_NUMBER:
-    return item.as_number.value;
+    return qleei_value_item_number(item);
   case QLEEI_VALUE_KIND_BOOL:
-    return (double)item.as_bool.value;
+    return (double)qleei_value_item_bool(item);
   case QLEEI_VALUE_KIND_POINTER:
-    return (double)(qleei_uisz_t)item.as_pointer.value;
+    return (double)(qleei_uisz_t)qleei_value_item_pointer(item);
   }
   return 0.0;
 }
 
+// Result of arithmetic on an item that isn't a pointer, it keeps the item's kind like qleei__verify_arithmetic_kind
+// assumes. A bool counts as 1 or 0 and becomes whether the result isn't 0, whichever way items are represented
+static Qleei_Value_Item qleei__value_item_with_number(Qleei_Value_Item item, double value) {
+  if (qleei_value_item_kind(item) == QLEEI_VALUE_KIND_BOOL) return qleei_value_item_from_bool(value != 0);
+  return qleei_value_item_from_number(value);
+}
+
 bool qleei_value_item_as_bool(Qleei_Value_Item item) {
-  switch (item.kind) {
+  switch (qleei_value_item_kind(item)) {
   case QLEEI_VALUE_KIND_NUMBER:
-    return item.as_number.value != 0;
+    return qleei_value_item_number(item) != 0;
   case QLEEI_VALUE_KIND_BOOL:
-    return item.as_bool.value;
+    return qleei_value_item_bool(item);
   case QLEEI_VALUE_KIND_POINTER:
-    return item.as_pointer.value != NULL;
+    return qleei_value_item_pointer(item) != NULL;
   }
   return false;
 }
 
-bool qleei_execute_while(Qleei_Interpreter *it, bool inside_of_proc) {
-  QLeei_Lexer *l = &it->lexer;
-  QLeei_Lex_Location start_point = qleei_lexer_save_point(l);
-  QLeei_Lex_Location end_point = {0};
-  bool end_point_found = false;
-  while (qleei_lexer_next(l)) {
-    QLeei_Token t = l->token;
-    if (qleei_sv_eq_zstr(t.string, "begin")) {
-      if (it->stack.len == 0) {
-	      qleei_printfn("[ERROR] While loop requires at least one element on the stack to do evaluation but nothing is on the stack");
-	      return false;
-      }
+/**
+ * A `while` loop that is still open while compiling.
+ */
+typedef struct {
+  QLeei_Token  token;      // `while` token that opened the loop
+  qleei_uisz_t start;      // First instruction of the condition
+  qleei_uisz_t exit_jump;  // `begin` jump to patch once the loop closes
+  bool         has_begin;
+} Qleei_Block;
 
-      Qleei_Value_Item item;
-      qleei_alist_pop(&it->stack, &item);
-      if (!qleei_value_item_as_bool(item)) {
-	      if (end_point_found) {
-	        qleei_lexer_restore_point(l, end_point);
-	        return true;
-	      }
-	      qleei_uisz_t level = 1;
-	      while (level > 0) {
-	        if (!qleei_lexer_next(l)) return false;
-	        t = l->token;
-	        if (qleei_sv_eq_zstr(t.string, "while")) {
-	          level++;
-	        } else if (qleei_sv_eq_zstr(t.string, "end")) {
-	          level--;
-	        }
-	      }
-	      return true;
-      }
+typedef struct {
+  Qleei_Block *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei_Blocks;
+
+// Loop conditions are copied after the loop body, jumps inside of them would need their targets moved too
+static bool qleei__loop_condition_can_be_replayed(Qleei_Code *code, qleei_uisz_t start, qleei_uisz_t end) {
+  for (qleei_uisz_t i = start; i < end; ++i) {
+    switch (code->items[i].kind) {
+    case QLEEI_OP_JUMP:
+    case QLEEI_OP_JUMP_UNLESS:
+    case QLEEI_OP_JUMP_IF:
+    case QLEEI_OP_RETURN:
+    case QLEEI_OP_HALT:
+      return false;
+    default:
+      break;
+    }
+  }
+  return true;
+}
 
-      continue;
+// Builtin words can't be shadowed by custom words or procedures, so they are bound while compiling.
+// The stack shuffling ones get their own instruction, the rest call their handler directly
+static Qleei_Op qleei__builtin_word_op(qleei_uisz_t index) {
+  Qleei_Word_Handler h = QLEEI_BUILTIN_WORDS[index].val.handler;
+  Qleei_Op op = { .kind = QLEEI_OP_BUILTIN, .arg = index };
+  if      (h == qleei__word_dup)   op.kind = QLEEI_OP_DUP;
+  else if (h == qleei__word_over)  op.kind = QLEEI_OP_OVER;
+  else if (h == qleei__word_drop)  op.kind = QLEEI_OP_DROP;
+  else if (h == qleei__word_rot2)  op.kind = QLEEI_OP_ROT2;
+  else if (h == qleei__word_swap2) op.kind = QLEEI_OP_ROT2;
+  else if (h == qleei__word_swap3) op.kind = QLEEI_OP_SWAP3;
+  else if (h == qleei__word_rot3)  op.kind = QLEEI_OP_ROT3;
+  return op;
+}
+
+// Sets `*closed` when `t` is the `end` that closes the procedure being compiled
+static bool qleei__compile_identifier(Qleei_Interpreter *it, Qleei_Code *code, Qleei_Blocks *blocks, QLeei_Token t, bool inside_of_proc, bool *closed) {
+  Qleei_Block *top = qleei_alist_last(blocks, Qleei_Block);
+
+  if (t.id == QLEEI_SYMBOL_WHILE) {
+    Qleei_Block block = { .token = t, .start = code->len };
+    return qleei_alist_append(blocks, &block);
+  }
+
+  if (t.id == QLEEI_SYMBOL_BEGIN) {
+    if (top == NULL || top->has_begin) {
+      qleei_loc_printfn(t.loc, "[ERROR] 'begin' is only allowed after the condition of a while loop");
+      return false;
     }
+    top->has_begin = true;
+    top->exit_jump = code->len;
+    Qleei_Op op = { .kind = QLEEI_OP_JUMP_UNLESS };
+    return qleei_code_emit(code, op, t);
+  }
 
-    if (qleei_sv_eq_zstr(t.string, "end")) {
-      if (!end_point_found) {
-	      end_point_found = true;
-	      end_point = qleei_lexer_save_point(l);
+  if (t.id == QLEEI_SYMBOL_END) {
+    if (top == NULL) {
+      if (!inside_of_proc) {
+        qleei_loc_printfn(t.loc, "[ERROR] 'end' does not close any while loop or procedure");
+        return false;
       }
-      qleei_lexer_restore_point(l, start_point);
-      continue;
+      Qleei_Op op = { .kind = QLEEI_OP_RETURN };
+      *closed = true;
+      return qleei_code_emit(code, op, t);
+    }
+    if (!top->has_begin) {
+      qleei_loc_printfn(t.loc, "[ERROR] While loop is missing 'begin' between its condition and its body");
+      return false;
+    }
+    qleei_uisz_t body_start = top->exit_jump + 1;
+    if (qleei__loop_condition_can_be_replayed(code, top->start, top->exit_jump)) {
+      // `while C begin B end` runs as `C JUMP_UNLESS(exit) B C JUMP_IF(B)`
+      for (qleei_uisz_t i = top->start; i < top->exit_jump; ++i) {
+        if (!qleei_code_emit(code, code->items[i], code->tokens.items[i])) return false;
+      }
+      Qleei_Op op = { .kind = QLEEI_OP_JUMP_IF, .arg = body_start };
+      if (!qleei_code_emit(code, op, code->tokens.items[top->exit_jump])) return false;
+    } else {
+      Qleei_Op op = { .kind = QLEEI_OP_JUMP, .arg = top->start };
+      if (!qleei_code_emit(code, op, t)) return false;
     }
+    code->items[top->exit_jump].arg = code->len;
+    blocks->len--;
+    return true;
+  }
 
-    if (t.kind == QLEEI_TOKEN_KIND_EOF) {
-      qleei_loc_printfn(start_point, "[ERROR] Unterminated while loop hit: missing 'end' at the end of the loop's body");
+  if (t.id == QLEEI_SYMBOL_PROC) {
+    if (inside_of_proc) {
+      qleei_loc_printfn(t.loc, "[ERROR] Cannot define a procedure while inside of a procedure");
       return false;
     }
+    return qleei_parse_proc(it);
+  }
 
-    if (!qleei_execute_token(it, inside_of_proc, t)) return false;
+  qleei_uisz_t builtin;
+  if (qleei__find_builtin_token(it, &t, &builtin)) {
+    return qleei_code_emit(code, qleei__builtin_word_op(builtin), t);
   }
 
-  return false;
+  Qleei_Op op = { .kind = QLEEI_OP_CALL };
+  return qleei_code_emit(code, op, t);
 }
 
+// Operation of each one byte symbol, indexed by the byte itself; QLEEI_OP_NONE marks unsupported symbols
+static const Qleei_Op_Kind QLEEI_SYMBOL_OPS[256] = {
+  ['+'] = QLEEI_OP_ADD,
+  ['-'] = QLEEI_OP_SUB,
+  ['/'] = QLEEI_OP_DIV,
+  ['*'] = QLEEI_OP_MUL,
+  ['!'] = QLEEI_OP_ABORT,
+};
+
+static bool qleei__compile_symbol(Qleei_Code *code, QLeei_Token t) {
+  Qleei_String_View sv = t.string;
+  Qleei_Op op = { .kind = QLEEI_SYMBOL_OPS[t.symbol] };
+  if (op.kind == QLEEI_OP_NONE) {
+    qleei_loc_printfn(t.loc, "[ERROR] Unsupported symbol '"QLEEI_SV_Fmt_Str"'", QLEEI_SV_Fmt_Arg(sv));
+    qleei_printf("[INFO] Symbol bytes: [");
+    qleei_sv_iter(c, sv) {
+      if (c > sv.data) qleei_printf(", ");
+      qleei_printf("%d", (int)*c);
+    }
+    qleei_printfn("]");
+    return false;
+  }
+  return qleei_code_emit(code, op, t);
+}
+
+// Compiles the lexer's tokens into `code` until the end of the input or, when `proc_token` is given,
+// until the `end` that closes that procedure's body
+static bool qleei__compile_tokens(Qleei_Interpreter *it, Qleei_Code *code, Qleei_Blocks *blocks, QLeei_Token *proc_token) {
+  QLeei_Lexer *l = &it->lexer;
+  bool inside_of_proc = proc_token != NULL;
+
+  while (qleei_lexer_next(l)) {
+    QLeei_Token t = l->token;
+    Qleei_Op op = {0};
+
+    switch (t.kind) {
+    case QLEEI_TOKEN_KIND_NONE:
+      qleei_printfn("[UNREACHABLE] qleei_compile switch (token.kind) case QLEEI_TOKEN_KIND_NONE");
+      return false;
+
+    case QLEEI_TOKEN_KIND_EOF:
+      {
+        Qleei_Block *top = qleei_alist_last(blocks, Qleei_Block);
+        if (top != NULL) {
+          qleei_loc_printfn(top->token.loc, "[ERROR] Unterminated while loop hit: missing 'end' at the end of the loop's body");
+          return false;
+        }
+        if (inside_of_proc) {
+          qleei_loc_printfn(proc_token->loc, "[ERROR] Procedure is missing to finish with 'end' keyword");
+          return false;
+        }
+      }
+      op.kind = QLEEI_OP_HALT;
+      return qleei_code_emit(code, op, t);
+
+    case QLEEI_TOKEN_KIND_IDENTIFIER:
+      {
+        bool closed = false;
+        if (!qleei__compile_identifier(it, code, blocks, t, inside_of_proc, &closed)) return false;
+        if (closed) return true;
+      }
+      break;
+
+    case QLEEI_TOKEN_KIND_NUMBER:
+      op.kind = QLEEI_OP_PUSH_NUMBER;
+      op.number = t.number;
+      if (!qleei_code_emit(code, op, t)) return false;
+      break;
+
+    case QLEEI_TOKEN_KIND_BOOL:
+      op.kind = QLEEI_OP_PUSH_BOOL;
+      op.number = t.number;
+      if (!qleei_code_emit(code, op, t)) return false;
+      break;
+
+    case QLEEI_TOKEN_KIND_SYMBOL:
+      if (!qleei__compile_symbol(code, t)) return false;
+      break;
+    }
+  }
+
+  return false;
+}
+
+// ==================================================
+// Superinstructions
+// --------------------------------------------------
+// A fused instruction replaces the first instruction of the sequence it was matched from, the rest of the
+// sequence stays in place so jumps into the middle of it still land on the original instructions.
+// The fused instruction keeps the literal `N` of the sequence in `number`, its length in `arg` and falls back
+// to the first instruction when the stack doesn't look like the fast path expects.
+
+#define QLEEI_FUSION_MAX_LEN 4
+
+typedef struct {
+  Qleei_Op_Kind      kind;
+  Qleei_Word_Handler handler; // Only checked for `QLEEI_OP_BUILTIN`
+} Qleei_Fusion_Op;
+
+typedef struct {
+  const char     *name;
+  Qleei_Op_Kind   fused;
+  Qleei_Fusion_Op ops[QLEEI_FUSION_MAX_LEN];
+  qleei_uisz_t    len;
+} Qleei_Fusion;
+
+#define QLEEI_FUSE_OP(k)   { QLEEI_OP_##k, NULL }
+#define QLEEI_FUSE_WORD(h) { QLEEI_OP_BUILTIN, (h) }
+
+// Tried in order at every instruction, longer patterns must come before the ones they start with
+static const Qleei_Fusion QLEEI_FUSIONS[] = {
+  { "dup dup * *",         QLEEI_OP_CUBE,               { QLEEI_FUSE_OP(DUP), QLEEI_FUSE_OP(DUP), QLEEI_FUSE_OP(MUL), QLEEI_FUSE_OP(MUL) }, 4 },
+  { "dup N +",             QLEEI_OP_DUP_PUSH_ADD,       { QLEEI_FUSE_OP(DUP), QLEEI_FUSE_OP(PUSH_NUMBER), QLEEI_FUSE_OP(ADD) }, 3 },
+  { "N rot2 mem_save_ui8", QLEEI_OP_PUSH_ROT2_SAVE_UI8, { QLEEI_FUSE_OP(PUSH_NUMBER), QLEEI_FUSE_OP(ROT2), QLEEI_FUSE_WORD(qleei__word_mem_save_ui8) }, 3 },
+  { "N rot2 -",            QLEEI_OP_PUSH_ROT2_SUB,      { QLEEI_FUSE_OP(PUSH_NUMBER), QLEEI_FUSE_OP(ROT2), QLEEI_FUSE_OP(SUB) }, 3 },
+  { "dup *",               QLEEI_OP_SQUARE,             { QLEEI_FUSE_OP(DUP), QLEEI_FUSE_OP(MUL) }, 2 },
+  { "N +",                 QLEEI_OP_PUSH_ADD,           { QLEEI_FUSE_OP(PUSH_NUMBER), QLEEI_FUSE_OP(ADD) }, 2 },
+};
+#undef QLEEI_FUSE_OP
+#undef QLEEI_FUSE_WORD
+static const qleei_uisz_t QLEEI_FUSION_COUNT = sizeof(QLEEI_FUSIONS) / sizeof(QLEEI_FUSIONS[0]);
+
+static bool qleei__fusion_matches(const Qleei_Fusion *fusion, Qleei_Code *code, qleei_uisz_t start) {
+  if (code->len - start < fusion->len) return false;
+  for (qleei_uisz_t i = 0; i < fusion->len; ++i) {
+    Qleei_Op *op = &code->items[start + i];
+    if (op->kind != fusion->ops[i].kind) return false;
+    if (op->kind == QLEEI_OP_BUILTIN && QLEEI_BUILTIN_WORDS[op->arg].val.handler != fusion->ops[i].handler) return false;
+  }
+  return true;
+}
+
+static void qleei__fuse_code(Qleei_Code *code) {
+  qleei_uisz_t i = 0;
+  while (i < code->len) {
+    qleei_uisz_t len = 1;
+    for (qleei_uisz_t f = 0; f < QLEEI_FUSION_COUNT; ++f) {
+      if (qleei__fusion_matches(&QLEEI_FUSIONS[f], code, i)) {
+        const Qleei_Fusion *fusion = &QLEEI_FUSIONS[f];
+        for (qleei_uisz_t j = 0; j < fusion->len; ++j) {
+          if (fusion->ops[j].kind == QLEEI_OP_PUSH_NUMBER) {
+            code->items[i].number = code->items[i + j].number;
+            break;
+          }
+        }
+        code->items[i].kind = fusion->fused;
+        code->items[i].arg  = fusion->len;
+        len = fusion->len;
+        break;
+      }
+    }
+    i += len;
+  }
+}
+
+// A superinstruction is still followed by the rest of its sequence, running its first instruction alone is equivalent
+static Qleei_Op_Kind qleei__fused_base_kind(Qleei_Op_Kind kind) {
+  for (qleei_uisz_t f = 0; f < QLEEI_FUSION_COUNT; ++f) {
+    if (QLEEI_FUSIONS[f].fused == kind) return QLEEI_FUSIONS[f].ops[0].kind;
+  }
+  return kind;
+}
+
+// Same as qleei__fused_base_kind, arithmetic the verifier specialised is also the instruction it replaced
+static Qleei_Op_Kind qleei__op_base_kind(Qleei_Op_Kind kind) {
+  switch (kind) {
+  case QLEEI_OP_ADD_NUMBERS: return QLEEI_OP_ADD;
+  case QLEEI_OP_SUB_NUMBERS: return QLEEI_OP_SUB;
+  case QLEEI_OP_MUL_NUMBERS: return QLEEI_OP_MUL;
+  case QLEEI_OP_DIV_NUMBERS: return QLEEI_OP_DIV;
+  default: return qleei__fused_base_kind(kind);
+  }
+}
+
+static void qleei__fusion_report_code(Qleei_Code *code, qleei_uisz_t *counts) {
+  qleei_alist_foreach(Qleei_Op, op, code) {
+    for (qleei_uisz_t f = 0; f < QLEEI_FUSION_COUNT; ++f) {
+      if (op->kind == QLEEI_FUSIONS[f].fused) counts[f] += 1;
+    }
+  }
+}
+
+void qleei_print_fusion_report(Qleei_Interpreter *it) {
+  qleei_uisz_t counts[sizeof(QLEEI_FUSIONS) / sizeof(QLEEI_FUSIONS[0])] = {0};
+  qleei__fusion_report_code(&it->code, counts);
+  qleei_alist_foreach(Qleei_Proc, proc, &it->procs) {
+    qleei__fusion_report_code(&proc->body, counts);
+  }
+
+  qleei_printfn("[INFO] Fused instructions:");
+  for (qleei_uisz_t f = 0; f < QLEEI_FUSION_COUNT; ++f) {
+    qleei_printfn("[INFO]   %s: %zu", QLEEI_FUSIONS[f].name, counts[f]);
+  }
+}
+
+// ==================================================
+// Verifier
+// --------------------------------------------------
+// The verifier walks the compiled code once it is fused, tracking what is known about the top of the stack before
+// every instruction. Arithmetic proven to only see numbers is replaced by instructions that skip the checks, and
+// calls to procedures whose inputs are proven remember it in `arg` so the executor skips the input check.
+// It relies on every procedure body starting with its inputs on the stack, which the checks at calls guarantee.
+
+#define QLEEI_VERIFY_UNKNOWN_KIND 0xFF
+
+typedef struct {
+  bool         reached;
+  bool         exact; // `base` is exact, the stack is the entry stack without its `base` top items plus `kinds`
+  qleei_uisz_t base;
+  qleei_uisz_t len;
+  qleei_ui8_t  kinds[QLEEI_VERIFY_MAX_DEPTH]; // `kinds[len - 1]` is the top
+} Qleei_Verify_State;
+
+static void qleei__verify_forget(Qleei_Verify_State *s) {
+  s->exact = false;
+  s->len = 0;
+}
+
+// Instructions only continue when the stack held what they needed, so missing items are known to exist
+static void qleei__verify_ensure(Qleei_Verify_State *s, qleei_uisz_t n) {
+  if (s->len >= n) return;
+  if (n > QLEEI_VERIFY_MAX_DEPTH) {
+    qleei__verify_forget(s);
+    return;
+  }
+  qleei_uisz_t missing = n - s->len;
+  for (qleei_uisz_t i = s->len; i > 0; --i) s->kinds[i - 1 + missing] = s->kinds[i - 1];
+  for (qleei_uisz_t i = 0; i < missing; ++i) s->kinds[i] = QLEEI_VERIFY_UNKNOWN_KIND;
+  s->len = n;
+  s->base += missing;
+}
+
+static void qleei__verify_pop(Qleei_Verify_State *s, qleei_uisz_t n) {
+  qleei__verify_ensure(s, n);
+  s->len = n <= s->len ? s->len - n : 0;
+}
+
+static void qleei__verify_push(Qleei_Verify_State *s, qleei_ui8_t kind) {
+  if (s->len == QLEEI_VERIFY_MAX_DEPTH) {
+    for (qleei_uisz_t i = 1; i < s->len; ++i) s->kinds[i - 1] = s->kinds[i];
+    s->len -= 1;
+    s->exact = false;
+  }
+  s->kinds[s->len++] = kind;
+}
+
+static qleei_ui8_t qleei__verify_top(Qleei_Verify_State *s, qleei_uisz_t n) {
+  return s->kinds[s->len - 1 - n];
+}
+
+static void qleei__verify_swap(Qleei_Verify_State *s, qleei_uisz_t a, qleei_uisz_t b) {
+  qleei_ui8_t tmp = s->kinds[s->len - 1 - a];
+  s->kinds[s->len - 1 - a] = s->kinds[s->len - 1 - b];
+  s->kinds[s->len - 1 - b] = tmp;
+}
+
+// Merges `from` into `into` keeping what holds on both, returns whether `into` changed
+static bool qleei__verify_merge(Qleei_Verify_State *into, Qleei_Verify_State *from) {
+  if (!into->reached) {
+    *into = *from;
+    into->reached = true;
+    return true;
+  }
+  Qleei_Verify_State merged = *into;
+  merged.exact = into->exact && from->exact && into->base == from->base && into->len == from->len;
+  merged.len = into->len < from->len ? into->len : from->len;
+  for (qleei_uisz_t i = 0; i < merged.len; ++i) {
+    qleei_ui8_t a = qleei__verify_top(into, i), b = qleei__verify_top(from, i);
+    merged.kinds[merged.len - 1 - i] = a == b ? a : QLEEI_VERIFY_UNKNOWN_KIND;
+  }
+  bool changed = merged.exact != into->exact || merged.len != into->len;
+  for (qleei_uisz_t i = 0; !changed && i < merged.len; ++i) changed = merged.kinds[i] != into->kinds[i];
+  *into = merged;
+  return changed;
+}
+
+typedef struct {
+  Qleei_Word_Handler handler;
+  qleei_uisz_t       pops;
+  bool               pushes;
+  qleei_ui8_t        pushed; // Kind of the pushed item
+} Qleei_Verify_Word;
+
+// Builtin words with a fixed effect on the stack, calling any other word forgets everything
+static const Qleei_Verify_Word QLEEI_VERIFY_WORDS[] = {
+  { qleei__word_print_number,  1, false, 0 },
+  { qleei__word_print_uisz,    1, false, 0 },
+  { qleei__word_print_ptr,     1, false, 0 },
+  { qleei__word_print_char,    1, false, 0 },
+  { qleei__word_print_bool,    1, false, 0 },
+  { qleei__word_print_stack,   0, false, 0 },
+  { qleei__word_print_zstr,    1, false, 0 },
+  { qleei__word_assert_empty,  0, false, 0 },
+  { qleei__word_mem_alloc,     1, true,  QLEEI_VALUE_KIND_POINTER },
+  { qleei__word_mem_free,      1, false, 0 },
+  { qleei__word_mem_save_si8,  2, false, 0 },
+  { qleei__word_mem_save_ui8,  2, false, 0 },
+  { qleei__word_mem_load_ui8,  1, true,  QLEEI_VALUE_KIND_NUMBER },
+  { qleei__word_mem_save_ui32, 2, false, 0 },
+  { qleei__word_mem_load_ui32, 1, true,  QLEEI_VALUE_KIND_NUMBER },
+};
+static const qleei_uisz_t QLEEI_VERIFY_WORD_COUNT = sizeof(QLEEI_VERIFY_WORDS) / sizeof(QLEEI_VERIFY_WORDS[0]);
+
+// Procedure called by `code->items[i]` as things stand while compiling, custom words shadow procedures
+static Qleei_Proc *qleei__verify_callee(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t i) {
+  QLeei_Token *t = &code->tokens.items[i];
+  if (qleei__find_word(it, t) != NULL) return NULL;
+  return qleei__find_proc(it, t);
+}
+
+static bool qleei__verify_inputs_proven(Qleei_Verify_State *s, Qleei_Proc *proc) {
+  if (proc->inputs.len > s->len) return false;
+  for (qleei_uisz_t i = 0; i < proc->inputs.len; ++i) {
+    if (qleei__verify_top(s, i) != proc->inputs.items[i]) return false;
+  }
+  return true;
+}
+
+// Arithmetic keeps the kind of the top operand, `+` and `-` with a pointer give a pointer
+static qleei_ui8_t qleei__verify_arithmetic_kind(Qleei_Op_Kind kind, qleei_ui8_t top, qleei_ui8_t second) {
+  if (kind == QLEEI_OP_MUL || kind == QLEEI_OP_DIV) return top;
+  if (top == QLEEI_VALUE_KIND_POINTER || second == QLEEI_VALUE_KIND_POINTER) return QLEEI_VALUE_KIND_POINTER;
+  if (top == QLEEI_VERIFY_UNKNOWN_KIND || second == QLEEI_VERIFY_UNKNOWN_KIND) return QLEEI_VERIFY_UNKNOWN_KIND;
+  return top;
+}
+
+// Applies the instruction to `s`, returns whether execution can continue with the next instruction
+static bool qleei__verify_step(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t i, Qleei_Verify_State *s) {
+  Qleei_Op *op = &code->items[i];
+  Qleei_Op_Kind kind = qleei__op_base_kind(op->kind);
+  switch (kind) {
+  case QLEEI_OP_HALT:
+  case QLEEI_OP_RETURN:
+  case QLEEI_OP_ABORT:
+  case QLEEI_OP_JUMP:
+    return false;
+
+  case QLEEI_OP_PUSH_NUMBER: qleei__verify_push(s, QLEEI_VALUE_KIND_NUMBER); break;
+  case QLEEI_OP_PUSH_BOOL:   qleei__verify_push(s, QLEEI_VALUE_KIND_BOOL);   break;
+  case QLEEI_OP_DROP:        qleei__verify_pop(s, 1);                        break;
+  case QLEEI_OP_JUMP_UNLESS:
+  case QLEEI_OP_JUMP_IF:     qleei__verify_pop(s, 1);                        break;
+
+  case QLEEI_OP_DUP:
+  case QLEEI_OP_OVER: {
+    qleei_uisz_t n = kind == QLEEI_OP_OVER ? 1 : 0;
+    qleei__verify_ensure(s, n + 1);
+    if (s->len == 0) break;
+    qleei__verify_push(s, qleei__verify_top(s, n));
+  } break;
+
+  case QLEEI_OP_ROT2:
+  case QLEEI_OP_SWAP3:
+  case QLEEI_OP_ROT3: {
+    qleei_uisz_t n = kind == QLEEI_OP_ROT2 ? 2 : 3;
+    qleei__verify_ensure(s, n);
+    if (s->len < n) break;
+    if (kind == QLEEI_OP_ROT2)  qleei__verify_swap(s, 0, 1);
+    if (kind == QLEEI_OP_SWAP3) qleei__verify_swap(s, 0, 2);
+    if (kind == QLEEI_OP_ROT3) {
+      qleei__verify_swap(s, 0, 1);
+      qleei__verify_swap(s, 1, 2);
+    }
+  } break;
+
+  case QLEEI_OP_ADD:
+  case QLEEI_OP_SUB:
+  case QLEEI_OP_MUL:
+  case QLEEI_OP_DIV: {
+    qleei__verify_ensure(s, 2);
+    if (s->len < 2) break;
+    qleei_ui8_t result = qleei__verify_arithmetic_kind(kind, qleei__verify_top(s, 0), qleei__verify_top(s, 1));
+    qleei__verify_pop(s, 2);
+    qleei__verify_push(s, result);
+  } break;
+
+  case QLEEI_OP_BUILTIN: {
+    const Qleei_Verify_Word *word = NULL;
+    for (qleei_uisz_t w = 0; w < QLEEI_VERIFY_WORD_COUNT; ++w) {
+      if (QLEEI_VERIFY_WORDS[w].handler == QLEEI_BUILTIN_WORDS[op->arg].val.handler) word = &QLEEI_VERIFY_WORDS[w];
+    }
+    if (word == NULL) {
+      qleei__verify_forget(s);
+      break;
+    }
+    qleei__verify_pop(s, word->pops);
+    if (word->pushes) qleei__verify_push(s, word->pushed);
+  } break;
+
+  case QLEEI_OP_CALL: {
+    Qleei_Proc *proc = qleei__verify_callee(it, code, i);
+    if (proc == NULL || !proc->effect.known) {
+      qleei__verify_forget(s);
+      break;
+    }
+    qleei__verify_pop(s, proc->effect.consumes);
+    for (qleei_uisz_t k = 0; k < proc->effect.produces_len; ++k) qleei__verify_push(s, proc->effect.produces[k]);
+  } break;
+
+  default:
+    qleei__verify_forget(s);
+    break;
+  }
+  return true;
+}
+
+static qleei_uisz_t qleei__verify_jump_target(Qleei_Op *op) {
+  switch (op->kind) {
+  case QLEEI_OP_JUMP:
+  case QLEEI_OP_JUMP_UNLESS:
+  case QLEEI_OP_JUMP_IF:
+    return op->arg;
+  default:
+    return (qleei_uisz_t)-1;
+  }
+}
+
+// `proc` is the procedure `code` is the body of, `NULL` for the main program
+static bool qleei__verify_code(Qleei_Interpreter *it, Qleei_Code *code, Qleei_Proc *proc) {
+  if (code->len == 0) return true;
+  Qleei_Verify_State *states = qleei_mem_alloc(code->len*sizeof(Qleei_Verify_State));
+  qleei_uisz_t *worklist = qleei_mem_alloc(code->len*sizeof(qleei_uisz_t));
+  bool *queued = qleei_mem_alloc(code->len*sizeof(bool));
+  if (states == NULL || worklist == NULL || queued == NULL) {
+    if (states != NULL)   qleei_mem_free(states);
+    if (worklist != NULL) qleei_mem_free(worklist);
+    if (queued != NULL)   qleei_mem_free(queued);
+    return false;
+  }
+  for (qleei_uisz_t i = 0; i < code->len; ++i) {
+    states[i].reached = false;
+    queued[i] = false;
+  }
+
+  Qleei_Verify_State entry = { .reached = true, .exact = true };
+  if (proc != NULL) {
+    for (qleei_uisz_t i = proc->inputs.len; i > 0; --i) qleei__verify_push(&entry, proc->inputs.items[i - 1]);
+    entry.base = proc->inputs.len;
+  }
+  states[0] = entry;
+  qleei_uisz_t pending = 0;
+  worklist[pending++] = 0;
+  queued[0] = true;
+
+  while (pending > 0) {
+    qleei_uisz_t i = worklist[--pending];
+    queued[i] = false;
+    Qleei_Verify_State s = states[i];
+    bool falls_through = qleei__verify_step(it, code, i, &s);
+
+    qleei_uisz_t successors[2] = { falls_through ? i + 1 : code->len, qleei__verify_jump_target(&code->items[i]) };
+    for (qleei_uisz_t k = 0; k < 2; ++k) {
+      qleei_uisz_t next = successors[k];
+      if (next >= code->len) continue;
+      if (qleei__verify_merge(&states[next], &s) && !queued[next]) {
+        worklist[pending++] = next;
+        queued[next] = true;
+      }
+    }
+  }
+
+  for (qleei_uisz_t i = 0; i < code->len; ++i) {
+    Qleei_Verify_State *s = &states[i];
+    Qleei_Op *op = &code->items[i];
+    if (!s->reached) continue;
+
+    bool numbers = s->len >= 2 && qleei__verify_top(s, 0) == QLEEI_VALUE_KIND_NUMBER && qleei__verify_top(s, 1) == QLEEI_VALUE_KIND_NUMBER;
+    switch (op->kind) {
+    case QLEEI_OP_ADD: if (numbers) op->kind = QLEEI_OP_ADD_NUMBERS; break;
+    case QLEEI_OP_SUB: if (numbers) op->kind = QLEEI_OP_SUB_NUMBERS; break;
+    case QLEEI_OP_MUL: if (numbers) op->kind = QLEEI_OP_MUL_NUMBERS; break;
+    case QLEEI_OP_DIV: if (numbers) op->kind = QLEEI_OP_DIV_NUMBERS; break;
+    case QLEEI_OP_CALL: {
+      Qleei_Proc *callee = qleei__verify_callee(it, code, i);
+      if (callee != NULL && qleei__verify_inputs_proven(s, callee)) op->arg = (callee - it->procs.items) + 1;
+    } break;
+    case QLEEI_OP_RETURN:
+      // Procedure bodies only have the `QLEEI_OP_RETURN` closing them
+      if (proc != NULL && s->exact) {
+        proc->effect.known = true;
+        proc->effect.consumes = s->base;
+        proc->effect.produces_len = s->len;
+        for (qleei_uisz_t k = 0; k < s->len; ++k) proc->effect.produces[k] = s->kinds[k];
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  qleei_mem_free(states);
+  qleei_mem_free(worklist);
+  qleei_mem_free(queued);
+  return true;
+}
+
+static bool qleei__compile_block(Qleei_Interpreter *it, Qleei_Code *code, QLeei_Token *proc_token) {
+  Qleei_Blocks blocks = {0};
+  bool result = qleei__compile_tokens(it, code, &blocks, proc_token);
+  if (result) qleei__fuse_code(code);
+  qleei_alist_free(&blocks);
+  return result;
+}
+
+// Reports procedures named like a word, which could never be called
+static bool qleei__proc_name_is_free(Qleei_Interpreter *it, const QLeei_Token *name) {
+  if (qleei__find_word(it, name) == NULL) return true;
+  qleei_loc_printfn(name->loc, "[ERROR] Cannot define procedure with name '"QLEEI_SV_Fmt_Str"': name conflicts with built-in or custom word", QLEEI_SV_Fmt_Arg(name->string));
+  return false;
+}
+
+static bool qleei__document_reuse_proc(Qleei_Document *doc, bool *reused);
+
 bool qleei_parse_proc(Qleei_Interpreter *it) {
+  if (it->document != NULL) {
+    bool reused = false;
+    if (!qleei__document_reuse_proc(it->document, &reused)) return false;
+    if (reused) return true;
+  }
+
   QLeei_Lexer *l = &it->lexer;
+  QLeei_Token proc_token = l->token;
+  qleei_uisz_t proc_cursor = l->cursor;
   if (!qleei_lexer_next(l)) return false;
   if (l->token.kind != QLEEI_TOKEN_KIND_IDENTIFIER) {
-    qleei_printfn("%zu:%zu: [ERROR] Procedure is required to be given a name after 'proc' keyword", l->token.loc.line, l->token.loc.column);
+    qleei_uisz_t line, column;
+    qleei_loc_line_column(l->token.loc, &line, &column);
+    qleei_printfn("%zu:%zu: [ERROR] Procedure is required to be given a name after 'proc' keyword", line, column);
     return false;
   }
 
-  Qleei_String_View name_sv = l->token.string;
-  if (qleei__get_word_handler(it, name_sv, NULL) != NULL) {
-    qleei_loc_printfn(l->token.loc, "[ERROR] Cannot define procedure with name '"QLEEI_SV_Fmt_Str"': name conflicts with built-in or custom word", QLEEI_SV_Fmt_Arg(name_sv));
-    return false;
-  }
+  if (!qleei__proc_name_is_free(it, &l->token)) return false;
   Qleei_Proc proc = {0};
-  proc.name_sv = name_sv;
+  proc.name_sv = l->token.string;
+  proc.source.name = l->token.id;
 
   if (!qleei_lexer_next(l)) return false;
 
   // ==================================================
   // Parse Inputs
   // --------------------------------------------------
-  if (!qleei_sv_eq_zstr(l->token.string, "[")) {
+  if (l->token.symbol != '[') {
     qleei_loc_printfn(l->token.loc, "[ERROR] After procedure name must specify inputs & outputs like `[] -> []`");
     qleei_printfn("[NOTE] The return type is just imaginary, we don't check if you honor it KEKW");
     return false;
   }
 
-  while (!qleei_sv_eq_zstr(l->token.string, "]")) {
+  while (l->token.symbol != ']') {
     if (!qleei_lexer_next(l)) {
       qleei_loc_printfn(l->token.loc, "[ERROR] After procedure name must specify inputs & outputs like `[] -> []`");
       qleei_printfn("[NOTE] The return type is just imaginary, we don't check if you honor it KEKW");
       return false;
     }
-    if (qleei_sv_eq_zstr(l->token.string, "]")) break;
+    if (l->token.symbol == ']') break;
 
     if (l->token.kind != QLEEI_TOKEN_KIND_IDENTIFIER) {
       qleei_loc_printfn(l->token.loc, "[ERROR] Unexpected %s token when expecting identifier for type name", qleei_get_token_kind_name(l->token.kind));
@@ -1680,11 +4510,11 @@ bool qleei_parse_proc(Qleei_Interpreter *it) {
       return false;
     }
 
-    if (qleei_sv_eq_zstr(l->token.string, "pointer") || qleei_sv_eq_zstr(l->token.string, "ptr")) {
+    if (l->token.id == QLEEI_SYMBOL_POINTER || l->token.id == QLEEI_SYMBOL_PTR) {
       qleei_value_kind_list_append(&proc.inputs.items, &proc.inputs.cap, &proc.inputs.len, QLEEI_VALUE_KIND_POINTER);
-    } else if (qleei_sv_eq_zstr(l->token.string, "number")) {
+    } else if (l->token.id == QLEEI_SYMBOL_NUMBER) {
       qleei_value_kind_list_append(&proc.inputs.items, &proc.inputs.cap, &proc.inputs.len, QLEEI_VALUE_KIND_NUMBER);
-    } else if (qleei_sv_eq_zstr(l->token.string, "bool")) {
+    } else if (l->token.id == QLEEI_SYMBOL_BOOL) {
       qleei_value_kind_list_append(&proc.inputs.items, &proc.inputs.cap, &proc.inputs.len, QLEEI_VALUE_KIND_BOOL);
     } else {
       qleei_loc_printfn(l->token.loc, "[ERROR] Invalid type name only 'pointer'/'ptr', 'number', and 'bool' types exist");
@@ -1694,12 +4524,12 @@ bool qleei_parse_proc(Qleei_Interpreter *it) {
     QLeei_Token t = {0};
     if (!qleei_lexer_peek(l, &t)) return false;
 
-    if (qleei_sv_eq_zstr(t.string, ",") || qleei_sv_eq_zstr(t.string, "]")) {
+    if (t.symbol == ',' || t.symbol == ']') {
       qleei_lexer_next(l);
     }
   }
 
-  if (!qleei_sv_eq_zstr(l->token.string, "]")) {
+  if (l->token.symbol != ']') {
     qleei_loc_printfn(l->token.loc, "[ERROR] After procedure name must specify inputs & outputs like `[] -> []`");
     qleei_printfn("[NOTE] Token source: '"QLEEI_SV_Fmt_Str"'", QLEEI_SV_Fmt_Arg(l->token.string));
     qleei_printfn("[NOTE] The return type is just imaginary, we don't check if you honor it KEKW");
@@ -1717,29 +4547,29 @@ bool qleei_parse_proc(Qleei_Interpreter *it) {
   // ==================================================
   // Parse Outputs
   // --------------------------------------------------
-  if (!qleei_sv_eq_zstr(l->token.string, "[")) {
+  if (l->token.symbol != '[') {
     qleei_loc_printfn(l->token.loc, "[ERROR] After procedure inputs outputs must be specified: <input> -> <output>");
     qleei_printfn("[NOTE] Found '"QLEEI_SV_Fmt_Str"' but expected '['", QLEEI_SV_Fmt_Arg(l->token.string));
     return false;
   }
 
-  while (l->token.kind != QLEEI_TOKEN_KIND_SYMBOL || !qleei_sv_eq_zstr(l->token.string, "]")) {
+  while (l->token.symbol != ']') {
     if (!qleei_lexer_next(l)) {
       qleei_loc_printfn(l->token.loc, "[ERROR] After procedure inputs outputs must be specified");
       return false;
     }
-    if (qleei_sv_eq_zstr(l->token.string, "]")) break;
+    if (l->token.symbol == ']') break;
 
     if (l->token.kind != QLEEI_TOKEN_KIND_IDENTIFIER) {
       qleei_loc_printfn(l->token.loc, "[ERROR] Unexpected %s token when expecting identifier for type name", qleei_get_token_kind_name(l->token.kind));
       return false;
     }
 
-    if (qleei_sv_eq_zstr(l->token.string, "pointer") || qleei_sv_eq_zstr(l->token.string, "ptr")) {
+    if (l->token.id == QLEEI_SYMBOL_POINTER || l->token.id == QLEEI_SYMBOL_PTR) {
       qleei_value_kind_list_append(&proc.outputs.items, &proc.outputs.cap, &proc.outputs.len, QLEEI_VALUE_KIND_POINTER);
-    } else if (qleei_sv_eq_zstr(l->token.string, "number")) {
+    } else if (l->token.id == QLEEI_SYMBOL_NUMBER) {
       qleei_value_kind_list_append(&proc.outputs.items, &proc.outputs.cap, &proc.outputs.len, QLEEI_VALUE_KIND_NUMBER);
-    } else if (qleei_sv_eq_zstr(l->token.string, "bool")) {
+    } else if (l->token.id == QLEEI_SYMBOL_BOOL) {
       qleei_value_kind_list_append(&proc.outputs.items, &proc.outputs.cap, &proc.outputs.len, QLEEI_VALUE_KIND_BOOL);
     } else {
       qleei_loc_printfn(l->token.loc, "[ERROR] Invalid type name only 'pointer'/'ptr', 'number', and 'bool' types exist");
@@ -1749,266 +4579,1032 @@ bool qleei_parse_proc(Qleei_Interpreter *it) {
     QLeei_Token t = {0};
     if (!qleei_lexer_peek(l, &t)) return false;
 
-    if (qleei_sv_eq_zstr(t.string, ",")) {
+    if (t.symbol == ',') {
       qleei_lexer_next(l);
     }
   }
 
-  if (!qleei_sv_eq_zstr(l->token.string, "]")) {
+  if (l->token.symbol != ']') {
     qleei_loc_printfn(l->token.loc, "[ERROR] After procedure inputs outputs must be specified");
     qleei_printfn("[NOTE] The return type is just imaginary, we don't check if you honor it KEKW");
     return false;
   }
 
 
+
   // ==================================================
   // Parse Body
   // --------------------------------------------------
-  proc.body_start = qleei_lexer_save_point(l);
-  qleei_uisz_t level = 1;
-  while (true) {
-    if (!qleei_lexer_next(l)) return false;
-    if (l->token.kind == QLEEI_TOKEN_KIND_NONE) {
-      qleei_printfn("[UNREACHABLE] Lexer.Token.kind == QLEEI_TOKEN_KIND_NONE in parse_proc");
-      return false;
-    }
-    if (l->token.kind == QLEEI_TOKEN_KIND_EOF) {
-      qleei_printfn("[ERROR] Procedure is missing to finish with 'end' keyword");
-      return false;
-    }
-    if (l->token.kind == QLEEI_TOKEN_KIND_IDENTIFIER) {
-      if (qleei_sv_eq_zstr(l->token.string, "while")) {
-	      level++;
-      } else if (qleei_sv_eq_zstr(l->token.string, "end")) {
-	      level--;
-	      if (level == 0) {
-          proc.body_end = qleei_lexer_save_point(l);
-          break;
-        }
-      }
-    }
+  if (!qleei__compile_block(it, &proc.body, &proc_token) || !qleei__verify_code(it, &proc.body, &proc)) {
+    qleei_code_free(&proc.body);
+    return false;
+  }
+  if (l->tokens != NULL) {
+    proc.source.first = proc_cursor - 1;
+    proc.source.end = l->cursor;
+    proc.source.offset = proc_token.loc.index;
   }
 
-  qleei_list_append((void**)&it->procs.items, sizeof(Qleei_Proc), &it->procs.cap, &it->procs.len, &proc);
+  if (!qleei_procs_append(&it->procs, proc)) {
+    qleei_code_free(&proc.body);
+    return false;
+  }
+  it->epoch += 1;
 
   return true;
 }
 
-bool qleei_execute_token(Qleei_Interpreter *it, bool inside_of_proc, QLeei_Token t) {
+bool qleei_compile(Qleei_Interpreter *it) {
+  it->code.len = 0;
+  it->code.tokens.len = 0;
+  it->code.calls.len = 0;
+  it->compiled = false;
+
+  // The whole input is lexed in one pass, compiling then replays its tokens
+  QLeei_Lexer *l = &it->lexer;
+  qleei__line_starts_forget(&it->lines);
+  l->lines = &it->lines;
+  if (l->tokens == NULL) {
+    l->symbols = &it->symbols;
+    if (!qleei__tokenize_lexer(&it->tokens, *l)) return false;
+    l->tokens = &it->tokens;
+    l->cursor = 0;
+  }
+
+  bool result = qleei__compile_block(it, &it->code, NULL) && qleei__verify_code(it, &it->code, NULL);
+
+  if (result) {
+    it->pc = 0;
+    it->compiled = true;
+  }
+  return result;
+}
+
+// Desktop builds compiled with GCC or Clang thread the instructions together with computed gotos: every
+// handler ends with its own indirect jump to the next one, so the branch predictor gets one entry per
+// instruction instead of a single shared one. Everything else falls back to a portable `switch`.
+#if defined(PLATFORM_DESKTOP) && (defined(__GNUC__) || defined(__clang__))
+#  define QLEEI_THREADED_DISPATCH
+#endif
+
+#ifdef QLEEI_THREADED_DISPATCH
+#  define QLEEI_OP(kind)     qleei__op_##kind:
+#  define QLEEI_DISPATCH()   do { op = &code->items[pc_local++]; goto *dispatch_table[op->kind]; } while (0)
+#  define QLEEI_NEXT()       do { if (single_step) QLEEI_EXIT(true); QLEEI_DISPATCH(); } while (0)
+#  define QLEEI_GOTO_OP(k)   goto *dispatch_table[(k)]
+#else
+#  define QLEEI_OP(kind)     case QLEEI_OP_##kind:
+#  define QLEEI_NEXT()       goto next
+#  define QLEEI_GOTO_OP(k)   do { kind = (k); goto dispatch; } while (0)
+#endif // QLEEI_THREADED_DISPATCH
+
+// Leaving from inside of a call reports the position in the code this function was given
+#define QLEEI_EXIT(result) \
+  do { \
+    QLEEI_SPILL(); \
+    if (it->frames.len > frames_base) { \
+      pc_local = it->frames.items[frames_base].pc; \
+      it->frames.len = frames_base; \
+    } \
+    *pc = pc_local; \
+    return (result); \
+  } while (0)
+#define QLEEI_OP_TOKEN       (code->tokens.items[pc_local - 1])
+// Superinstructions jump over the rest of the sequence they replaced
+#define QLEEI_SKIP_FUSED()   do { pc_local += op->arg - 1; QLEEI_NEXT(); } while (0)
+
+// The top of the stack is kept in `top` while `top_cached` is set, the items below it stay in `stack`.
+// Instructions that don't know about it spill it back before touching the stack
+#define QLEEI_SPILL()        do { if (top_cached) { qleei_alist_append(stack, &top); top_cached = false; } } while (0)
+#define QLEEI_FILL()         do { if (!top_cached && stack->len > 0) { top = stack->items[--stack->len]; top_cached = true; } } while (0)
+#define QLEEI_CACHE(item)    do { QLEEI_SPILL(); top = (item); top_cached = true; } while (0)
+// `top <op> second` with both of them numbers stays in `top`, anything else goes through the instruction's checks
+#define QLEEI_CACHED_ARITHMETIC(operator) \
+  do { \
+    QLEEI_FILL(); \
+    if (top_cached && stack->len > 0 && qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER && qleei_value_item_kind(stack->items[stack->len - 1]) == QLEEI_VALUE_KIND_NUMBER) { \
+      top = qleei_value_item_from_number(qleei_value_item_number(top) operator qleei_value_item_number(stack->items[--stack->len])); \
+      QLEEI_NEXT(); \
+    } \
+    QLEEI_SPILL(); \
+  } while (0)
+// The verifier proved both operands are numbers. Their depth is still checked: a stack the proof doesn't
+// hold for goes through `base`, the instruction that was specialised, and reports its error
+#define QLEEI_PROVEN_ARITHMETIC(operator, base) \
+  do { \
+    QLEEI_FILL(); \
+    if (!top_cached || stack->len == 0) QLEEI_GOTO_OP(base); \
+    top = qleei_value_item_from_number(qleei_value_item_number(top) operator qleei_value_item_number(stack->items[--stack->len])); \
+    QLEEI_NEXT(); \
+  } while (0)
+
+#ifdef QLEEI_JIT
+static bool qleei__jit_call(Qleei_Interpreter *it, Qleei_Proc *proc);
+#endif // QLEEI_JIT
+
+// Builtin words are bound while compiling, a call can only name a custom word or a procedure.
+// Indices stay valid until the interpreter's `epoch` changes
+static void qleei__resolve_call(Qleei_Interpreter *it, const QLeei_Token *t, Qleei_Call_Cache *cache) {
+  cache->epoch = it->epoch;
+  cache->word = 0;
+  cache->proc = 0;
+  Qleei_Symbol *symbol = qleei__token_symbol(it, t);
+  if (symbol != NULL) {
+    cache->word = symbol->word;
+    if (symbol->word == 0) cache->proc = symbol->proc;
+    return;
+  }
+  Qleei_Custom_Word *word = qleei__custom_words_find(&it->words, t->string);
+  if (word != NULL) {
+    cache->word = (word - it->words.items) + 1;
+    return;
+  }
+  Qleei_Proc *proc = qleei_procs_find_by_sv_name(&it->procs, t->string);
+  if (proc != NULL) cache->proc = (proc - it->procs.items) + 1;
+}
+
+// Checks the inputs of a word registered with a signature and lets it work on their stack slots
+static bool qleei__call_fast_word(Qleei_Interpreter *it, Qleei_Custom_Word *word, QLeei_Token *t) {
   Qleei_Stack *stack = &it->stack;
-  Qleei_String_View sv = t.string;
+  const Qleei_Word_Signature *sig = word->val.signature;
+  if (!qleei_stack_operation_requires_n_items(t->loc, stack, t->string, sig->inputs_len)) return false;
+  qleei_uisz_t base = stack->len - sig->inputs_len;
+  for (qleei_uisz_t i = 0; i < sig->inputs_len; ++i) {
+    if (!qleei_action_expects_value_kind(t->loc, t->string, qleei_value_item_kind(stack->items[base + i]), sig->inputs[i])) return false;
+  }
+  if (sig->outputs_len > sig->inputs_len && !qleei_alist_reserve(stack, base + sig->outputs_len)) return false;
+
+  Qleei_Word_Context ctx = { .user_data = word->val.user_data != NULL ? word->val.user_data : it, .token = t };
+  Qleei_Value_Item *slots = stack->items + base;
+  if (!word->val.fast(&ctx, slots)) return false;
+#ifndef QLEEI_NAN_BOXING
+  // Handlers written against the tagged union may only store the value
+  for (qleei_uisz_t i = 0; i < sig->outputs_len; ++i) slots[i].kind = sig->outputs[i];
+#endif // QLEEI_NAN_BOXING
+  stack->len = base + sig->outputs_len;
+  return true;
+}
 
-  switch (t.kind) {
-  case QLEEI_TOKEN_KIND_NONE:
-    qleei_printfn("[UNREACHABLE] qleei_interpreter_step switch (lexer.kind) case QLEEI_TOKEN_KIND_NONE");
-    return false;
+// Shared by qleei_execute_op and qleei_execute_code, `single_step` stops after the first instruction
+static bool qleei__execute(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t *pc, bool inside_of_proc, bool single_step) {
+  Qleei_Stack *stack = &it->stack;
+  qleei_uisz_t pc_local = *pc;
+  Qleei_Op *op;
+  Qleei_Value_Item top;
+  bool top_cached = false;
+  qleei_uisz_t frames_base = it->frames.len;
+
+#ifdef QLEEI_THREADED_DISPATCH
+  static void *dispatch_table[] = {
+    [QLEEI_OP_NONE]        = &&qleei__op_NONE,
+    [QLEEI_OP_HALT]        = &&qleei__op_HALT,
+    [QLEEI_OP_PUSH_NUMBER] = &&qleei__op_PUSH_NUMBER,
+    [QLEEI_OP_PUSH_BOOL]   = &&qleei__op_PUSH_BOOL,
+    [QLEEI_OP_ADD]         = &&qleei__op_ADD,
+    [QLEEI_OP_SUB]         = &&qleei__op_SUB,
+    [QLEEI_OP_MUL]         = &&qleei__op_MUL,
+    [QLEEI_OP_DIV]         = &&qleei__op_DIV,
+    [QLEEI_OP_ABORT]       = &&qleei__op_ABORT,
+    [QLEEI_OP_DUP]         = &&qleei__op_DUP,
+    [QLEEI_OP_OVER]        = &&qleei__op_OVER,
+    [QLEEI_OP_DROP]        = &&qleei__op_DROP,
+    [QLEEI_OP_ROT2]        = &&qleei__op_ROT2,
+    [QLEEI_OP_SWAP3]       = &&qleei__op_SWAP3,
+    [QLEEI_OP_ROT3]        = &&qleei__op_ROT3,
+    [QLEEI_OP_BUILTIN]     = &&qleei__op_BUILTIN,
+    [QLEEI_OP_DUP_PUSH_ADD]       = &&qleei__op_DUP_PUSH_ADD,
+    [QLEEI_OP_PUSH_ADD]           = &&qleei__op_PUSH_ADD,
+    [QLEEI_OP_PUSH_ROT2_SUB]      = &&qleei__op_PUSH_ROT2_SUB,
+    [QLEEI_OP_PUSH_ROT2_SAVE_UI8] = &&qleei__op_PUSH_ROT2_SAVE_UI8,
+    [QLEEI_OP_SQUARE]             = &&qleei__op_SQUARE,
+    [QLEEI_OP_CUBE]               = &&qleei__op_CUBE,
+    [QLEEI_OP_ADD_NUMBERS]        = &&qleei__op_ADD_NUMBERS,
+    [QLEEI_OP_SUB_NUMBERS]        = &&qleei__op_SUB_NUMBERS,
+    [QLEEI_OP_MUL_NUMBERS]        = &&qleei__op_MUL_NUMBERS,
+    [QLEEI_OP_DIV_NUMBERS]        = &&qleei__op_DIV_NUMBERS,
+    [QLEEI_OP_CALL]        = &&qleei__op_CALL,
+    [QLEEI_OP_JUMP]        = &&qleei__op_JUMP,
+    [QLEEI_OP_JUMP_UNLESS] = &&qleei__op_JUMP_UNLESS,
+    [QLEEI_OP_JUMP_IF]     = &&qleei__op_JUMP_IF,
+    [QLEEI_OP_RETURN]      = &&qleei__op_RETURN,
+  };
 
-  case QLEEI_TOKEN_KIND_EOF:
+  QLEEI_DISPATCH();
+  {
+#else
+  Qleei_Op_Kind kind;
+  while (true) {
+    op = &code->items[pc_local++];
+    kind = op->kind;
+  dispatch:
+    switch (kind) {
+#endif // QLEEI_THREADED_DISPATCH
+
+  QLEEI_OP(NONE)
+    qleei_printfn("[UNREACHABLE] qleei_execute_op switch (op.kind) case QLEEI_OP_NONE");
+    QLEEI_EXIT(false);
+
+  QLEEI_OP(HALT)
+    // Stay on the halt so stepping a finished program is harmless
+    pc_local -= 1;
     it->done = true;
-    return true;
+    QLEEI_EXIT(true);
+
+  QLEEI_OP(RETURN)
+    if (it->frames.len > frames_base) {
+      Qleei_Frame *frame = &it->frames.items[--it->frames.len];
+      code = frame->code;
+      pc_local = frame->pc;
+      inside_of_proc = frame->inside_of_proc;
+      QLEEI_NEXT();
+    }
+    QLEEI_EXIT(true);
 
-  case QLEEI_TOKEN_KIND_IDENTIFIER:
+  QLEEI_OP(CALL)
+    QLEEI_SPILL();
     {
-      void *user_data = NULL;
-      Qleei_Word_Handler h = qleei__get_word_handler(it, sv, &user_data);
-      if (h != NULL) {
+      QLeei_Token *t = &QLEEI_OP_TOKEN;
+      Qleei_Call_Cache *cache = &code->calls.items[pc_local - 1];
+      if (cache->epoch != it->epoch || (cache->word == 0 && cache->proc == 0)) qleei__resolve_call(it, t, cache);
+
+      if (cache->word != 0) {
+        Qleei_Custom_Word *word = &it->words.items[cache->word - 1];
+        if (word->val.fast != NULL) {
+          if (!qleei__call_fast_word(it, word, t)) QLEEI_EXIT(false);
+          QLEEI_NEXT();
+        }
         Qleei_Word_Handler_Opt handler_opt = {
-          .token = t,
+          .token = *t,
           .stack = stack,
           .procs = &it->procs,
           .inside_proc = inside_of_proc,
-          .user_data = user_data,
+          .user_data = word->val.user_data != NULL ? word->val.user_data : it,
         };
-        if (!h(handler_opt)) return false;
-        return true;
+        if (!word->val.handler(handler_opt)) QLEEI_EXIT(false);
+        QLEEI_NEXT();
       }
-    }
 
-    {
-      Qleei_Proc *proc = qleei_procs_find_by_sv_name(&it->procs, sv);
-      if (proc != NULL) {
-	      if (!qleei_stack_operation_requires_n_items(t.loc, stack, sv, proc->inputs.len)) return false;
-	      for (qleei_uisz_t i = 0; i < proc->inputs.len; ++i) {
-	        Qleei_Value_Kind received = (stack->items[(proc->inputs.len - (i + 1))]).kind;
-	        Qleei_Value_Kind expected = proc->inputs.items[i];
-	        if (received != expected) {
-	          qleei_printfn("[ERROR] Proc "QLEEI_SV_Fmt_Str" expected %s but got %s", QLEEI_SV_Fmt_Arg(proc->name_sv), qleei_get_value_kind_name(expected), qleei_get_value_kind_name(received));
-	          return false;
+      if (cache->proc != 0) {
+	      Qleei_Proc *proc = &it->procs.items[cache->proc - 1];
+	      bool proven = op->arg == cache->proc;
+	      if (!proven && !qleei_proc_check_inputs(proc, stack, *t)) QLEEI_EXIT(false);
+	      // A single step runs the whole call
+	      if (single_step) {
+	        if (!qleei_execute_proc(it, proc)) QLEEI_EXIT(false);
+	        QLEEI_NEXT();
+	      }
+#ifdef QLEEI_JIT
+	      if (qleei__jit_call(it, proc)) QLEEI_NEXT();
+#endif // QLEEI_JIT
+	      // Nothing is left to run after a call followed by a return, the callee returns to our caller instead. Only the
+	      // last call of a body is followed by one, and with no conditionals to end a recursion this mostly saves frames
+	      // on chains of procedures rather than letting procedures recurse without bound
+	      bool tail_call = code->items[pc_local].kind == QLEEI_OP_RETURN && it->frames.len > frames_base;
+	      if (!tail_call) {
+	        if (it->frames.len >= QLEEI_MAX_CALL_DEPTH) {
+	          qleei_loc_printfn(t->loc, "[ERROR] Too many nested procedure calls, the limit is %d", QLEEI_MAX_CALL_DEPTH);
+	          QLEEI_EXIT(false);
 	        }
+	        Qleei_Frame frame = { .code = code, .pc = pc_local, .inside_of_proc = inside_of_proc };
+	        if (!qleei_alist_append(&it->frames, &frame)) QLEEI_EXIT(false);
 	      }
-	      if (!qleei_execute_proc(it, proc)) return false;
-	      return true;
+	      code = &proc->body;
+	      pc_local = 0;
+	      inside_of_proc = true;
+	      QLEEI_NEXT();
       }
+
+      qleei_loc_printfn(t->loc, "[ERROR] Unknown command/identifier provided: '%.*s'", (int)t->string.len, t->string.data);
+      QLEEI_EXIT(false);
     }
 
-    qleei_loc_printfn(t.loc, "[ERROR] Unknown command/identifier provided: '%.*s'", (int)sv.len, sv.data);
-    return false;
+  QLEEI_OP(BUILTIN)
+    QLEEI_SPILL();
+    {
+      Qleei_Word_Handler_Opt handler_opt = {
+        .token = QLEEI_OP_TOKEN,
+        .stack = stack,
+        .procs = &it->procs,
+        .inside_proc = inside_of_proc,
+        .user_data = it,
+      };
+      if (!QLEEI_BUILTIN_WORDS[op->arg].val.handler(handler_opt)) QLEEI_EXIT(false);
+    }
+    QLEEI_NEXT();
 
-  case QLEEI_TOKEN_KIND_NUMBER:
+  QLEEI_OP(PUSH_NUMBER)
     {
-      Qleei_Value_Item item = { .as_number = { .kind = QLEEI_VALUE_KIND_NUMBER, .value = t.number } };
-      qleei_alist_append(stack, &item);
+      Qleei_Value_Item item = qleei_value_item_from_number(op->number);
+      QLEEI_CACHE(item);
     }
-    return true;
+    QLEEI_NEXT();
 
-  case QLEEI_TOKEN_KIND_BOOL:
+  QLEEI_OP(PUSH_BOOL)
     {
-      Qleei_Value_Item item = { .as_bool = { .kind = QLEEI_VALUE_KIND_BOOL, .value = t.number == 1.0 } };
-      qleei_alist_append(stack, &item);
+      Qleei_Value_Item item = qleei_value_item_from_bool(op->number == 1.0);
+      QLEEI_CACHE(item);
     }
-    return true;
+    QLEEI_NEXT();
 
-  case QLEEI_TOKEN_KIND_SYMBOL:
-    if (qleei_sv_eq_zstr(sv, "+")) {
-      if (!qleei_stack_operation_requires_n_items(t.loc, stack, sv, 2)) return false;
+  QLEEI_OP(DUP)
+    // The copy left in the stack is the one below the top
+    if (top_cached) {
+      qleei_alist_append(stack, &top);
+    } else {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 1)) QLEEI_EXIT(false);
+      top = stack->items[stack->len - 1];
+      top_cached = true;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(OVER)
+    QLEEI_SPILL();
+    if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
+    top = stack->items[stack->len - 2];
+    top_cached = true;
+    QLEEI_NEXT();
+
+  QLEEI_OP(DROP)
+    if (top_cached) {
+      top_cached = false;
+      QLEEI_NEXT();
+    }
+    if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 1)) QLEEI_EXIT(false);
+    stack->len -= 1;
+    QLEEI_NEXT();
+
+  QLEEI_OP(ROT2)
+    if (top_cached && stack->len > 0) {
+      Qleei_Value_Item tmp = top;
+      top = stack->items[stack->len - 1];
+      stack->items[stack->len - 1] = tmp;
+      QLEEI_NEXT();
+    }
+    QLEEI_SPILL();
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
+      Qleei_Value_Item *top = &stack->items[stack->len - 1];
+      Qleei_Value_Item tmp = top[0];
+      top[0] = top[-1];
+      top[-1] = tmp;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(SWAP3)
+    QLEEI_SPILL();
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 3)) QLEEI_EXIT(false);
+      Qleei_Value_Item *top = &stack->items[stack->len - 1];
+      Qleei_Value_Item tmp = top[0];
+      top[0] = top[-2];
+      top[-2] = tmp;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(ROT3)
+    QLEEI_SPILL();
+    {
+      // [a b c] -> [c a b]: same as swapping the 1st with the 3rd and then the 1st with the 2nd
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 3)) QLEEI_EXIT(false);
+      Qleei_Value_Item *top = &stack->items[stack->len - 1];
+      Qleei_Value_Item tmp = top[0];
+      top[0] = top[-1];
+      top[-1] = top[-2];
+      top[-2] = tmp;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(DUP_PUSH_ADD)
+    QLEEI_FILL();
+    if (top_cached) {
+      if (qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER) {
+        qleei_alist_append(stack, &top);
+        top = qleei_value_item_from_number(op->number + qleei_value_item_number(top));
+        QLEEI_SKIP_FUSED();
+      }
+      if (qleei_value_item_kind(top) == QLEEI_VALUE_KIND_POINTER) {
+        qleei_alist_append(stack, &top);
+        top = qleei_value_item_from_pointer(qleei_value_item_pointer(top) + (qleei_uisz_t)op->number);
+        QLEEI_SKIP_FUSED();
+      }
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_DUP);
+
+  QLEEI_OP(PUSH_ADD)
+    QLEEI_FILL();
+    if (top_cached) {
+      if (qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER) {
+        top = qleei_value_item_from_number(op->number + qleei_value_item_number(top));
+        QLEEI_SKIP_FUSED();
+      }
+      if (qleei_value_item_kind(top) == QLEEI_VALUE_KIND_POINTER) {
+        top = qleei_value_item_from_pointer(qleei_value_item_pointer(top) + (qleei_uisz_t)op->number);
+        QLEEI_SKIP_FUSED();
+      }
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_PUSH_NUMBER);
+
+  QLEEI_OP(PUSH_ROT2_SUB)
+    QLEEI_FILL();
+    if (top_cached && qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER) {
+      top = qleei_value_item_from_number(qleei_value_item_number(top) - op->number);
+      QLEEI_SKIP_FUSED();
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_PUSH_NUMBER);
+
+  QLEEI_OP(PUSH_ROT2_SAVE_UI8)
+    QLEEI_FILL();
+    if (top_cached && qleei_value_item_kind(top) == QLEEI_VALUE_KIND_POINTER) {
+      *(qleei_ui8_t*)qleei_value_item_pointer(top) = (qleei_ui8_t)op->number;
+      top_cached = false;
+      QLEEI_SKIP_FUSED();
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_PUSH_NUMBER);
+
+  QLEEI_OP(SQUARE)
+    QLEEI_FILL();
+    if (top_cached && qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER) {
+      double x = qleei_value_item_number(top);
+      top = qleei_value_item_from_number(x * x);
+      QLEEI_SKIP_FUSED();
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_DUP);
+
+  QLEEI_OP(CUBE)
+    QLEEI_FILL();
+    if (top_cached && qleei_value_item_kind(top) == QLEEI_VALUE_KIND_NUMBER) {
+      double x = qleei_value_item_number(top);
+      top = qleei_value_item_from_number((x * x) * x);
+      QLEEI_SKIP_FUSED();
+    }
+    QLEEI_GOTO_OP(QLEEI_OP_DUP);
+
+  QLEEI_OP(JUMP)
+    pc_local = op->arg;
+    QLEEI_NEXT();
+
+  QLEEI_OP(JUMP_UNLESS)
+    if (top_cached) {
+      top_cached = false;
+      if (!qleei_value_item_as_bool(top)) pc_local = op->arg;
+      QLEEI_NEXT();
+    }
+    {
+      if (stack->len == 0) {
+	      qleei_printfn("[ERROR] While loop requires at least one element on the stack to do evaluation but nothing is on the stack");
+	      QLEEI_EXIT(false);
+      }
+      Qleei_Value_Item item;
+      qleei_alist_pop(stack, &item);
+      if (!qleei_value_item_as_bool(item)) pc_local = op->arg;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(JUMP_IF)
+    if (top_cached) {
+      top_cached = false;
+      if (qleei_value_item_as_bool(top)) pc_local = op->arg;
+      QLEEI_NEXT();
+    }
+    {
+      if (stack->len == 0) {
+	      qleei_printfn("[ERROR] While loop requires at least one element on the stack to do evaluation but nothing is on the stack");
+	      QLEEI_EXIT(false);
+      }
+      Qleei_Value_Item item;
+      qleei_alist_pop(stack, &item);
+      if (qleei_value_item_as_bool(item)) pc_local = op->arg;
+    }
+    QLEEI_NEXT();
+
+  QLEEI_OP(ADD)
+    QLEEI_CACHED_ARITHMETIC(+);
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
       Qleei_Value_Item a, b;
       qleei_alist_pop(stack, &a);
       qleei_alist_pop(stack, &b);
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER && b.kind == QLEEI_VALUE_KIND_POINTER) {
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER && qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
 	      qleei_printfn("[ERROR] Cannot add 2 pointers together");
-	      return false;
+	      QLEEI_EXIT(false);
       }
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER || b.kind == QLEEI_VALUE_KIND_POINTER) {
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER || qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
 	      char *ptr;
 	      qleei_uisz_t n;
-	      if (a.kind == QLEEI_VALUE_KIND_POINTER) {
-	        ptr = a.as_pointer.value;
+	      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER) {
+	        ptr = qleei_value_item_pointer(a);
 	        n = (qleei_uisz_t)qleei_value_item_as_number(b);
 	      } else {
-	        ptr = b.as_pointer.value;
+	        ptr = qleei_value_item_pointer(b);
 	        n = (qleei_uisz_t)qleei_value_item_as_number(a);
 	      }
-	      a.as_pointer.kind = QLEEI_VALUE_KIND_POINTER;
-	      a.as_pointer.value = ptr + n;
+	      a = qleei_value_item_from_pointer(ptr + n);
 	      qleei_alist_append(stack, &a);
-	      return true;
+	      QLEEI_NEXT();
       }
 
-      a.as_number.value = qleei_value_item_as_number(a) + qleei_value_item_as_number(b);
+      a = qleei__value_item_with_number(a, qleei_value_item_as_number(a) + qleei_value_item_as_number(b));
       qleei_alist_append(stack, &a);
-      return true;
     }
+    QLEEI_NEXT();
 
-    if (qleei_sv_eq_zstr(sv, "-")) {
-      if (!qleei_stack_operation_requires_n_items(t.loc, stack, sv, 2)) return false;
+  QLEEI_OP(SUB)
+    QLEEI_CACHED_ARITHMETIC(-);
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
       Qleei_Value_Item a, b;
       qleei_alist_pop(stack, &a);
       qleei_alist_pop(stack, &b);
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER && b.kind == QLEEI_VALUE_KIND_POINTER) {
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER && qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
 	      qleei_printfn("[ERROR] Cannot do subtraction between 2 pointers");
-	      return false;
+	      QLEEI_EXIT(false);
       }
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER || b.kind == QLEEI_VALUE_KIND_POINTER) {
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER || qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
 	      char *ptr;
 	      qleei_uisz_t n;
-	      if (a.kind == QLEEI_VALUE_KIND_POINTER) {
-	        ptr = a.as_pointer.value;
+	      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER) {
+	        ptr = qleei_value_item_pointer(a);
 	        n = (qleei_uisz_t)qleei_value_item_as_number(b);
 	      } else {
-	        ptr = b.as_pointer.value;
+	        ptr = qleei_value_item_pointer(b);
 	        n = (qleei_uisz_t)qleei_value_item_as_number(a);
 	      }
 
 	      if (n > (qleei_uisz_t)ptr) {
 	        qleei_printfn("[ERROR] Pointer arithmetic ends results in a negative value");
-	        return false;
+	        QLEEI_EXIT(false);
 	      }
 
-	      a.as_pointer.kind  = QLEEI_VALUE_KIND_POINTER;
-	      a.as_pointer.value = ptr - n;
+	      a = qleei_value_item_from_pointer(ptr - n);
 	      qleei_alist_append(stack, &a);
-	      return true;
+	      QLEEI_NEXT();
       }
 
-      a.as_number.value = qleei_value_item_as_number(a) - qleei_value_item_as_number(b);
+      a = qleei__value_item_with_number(a, qleei_value_item_as_number(a) - qleei_value_item_as_number(b));
       qleei_alist_append(stack, &a);
-      return true;
     }
+    QLEEI_NEXT();
 
-    if (qleei_sv_eq_zstr(sv, "/")) {
-      if (!qleei_stack_operation_requires_n_items(t.loc, stack, sv, 2)) return false;
+  QLEEI_OP(DIV)
+    QLEEI_CACHED_ARITHMETIC(/);
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
       Qleei_Value_Item a, b;
       qleei_alist_pop(stack, &a);
       qleei_alist_pop(stack, &b);
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER || b.kind == QLEEI_VALUE_KIND_POINTER) {
-	      qleei_loc_printfn(t.loc, "[ERROR] Cannot do division with pointers");
-	      return false;
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER || qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
+	      qleei_loc_printfn(QLEEI_OP_TOKEN.loc, "[ERROR] Cannot do division with pointers");
+	      QLEEI_EXIT(false);
       }
 
-      a.as_number.value = qleei_value_item_as_number(a) / qleei_value_item_as_number(b);
+      a = qleei__value_item_with_number(a, qleei_value_item_as_number(a) / qleei_value_item_as_number(b));
       qleei_alist_append(stack, &a);
-      return true;
     }
+    QLEEI_NEXT();
 
-    if (qleei_sv_eq_zstr(sv, "*")) {
-      if (!qleei_stack_operation_requires_n_items(t.loc, stack, sv, 2)) return false;
+  QLEEI_OP(MUL)
+    QLEEI_CACHED_ARITHMETIC(*);
+    {
+      if (!qleei_stack_operation_requires_n_items(QLEEI_OP_TOKEN.loc, stack, QLEEI_OP_TOKEN.string, 2)) QLEEI_EXIT(false);
       Qleei_Value_Item a, b;
       qleei_alist_pop(stack, &a);
       qleei_alist_pop(stack, &b);
 
-      if (a.kind == QLEEI_VALUE_KIND_POINTER || b.kind == QLEEI_VALUE_KIND_POINTER) {
-	      qleei_loc_printfn(t.loc, "[ERROR] Cannot do multiplication with pointers");
-	      return false;
+      if (qleei_value_item_kind(a) == QLEEI_VALUE_KIND_POINTER || qleei_value_item_kind(b) == QLEEI_VALUE_KIND_POINTER) {
+	      qleei_loc_printfn(QLEEI_OP_TOKEN.loc, "[ERROR] Cannot do multiplication with pointers");
+	      QLEEI_EXIT(false);
       }
 
-      a.as_number.value = qleei_value_item_as_number(a) * qleei_value_item_as_number(b);
+      a = qleei__value_item_with_number(a, qleei_value_item_as_number(a) * qleei_value_item_as_number(b));
       qleei_alist_append(stack, &a);
-      return true;
     }
+    QLEEI_NEXT();
 
-    if (qleei_sv_eq_zstr(sv, "!")) {
-      qleei_loc_printfn(t.loc, "[SYSTEM] ABORTED");
-      qleei_printf("[NOTE] Stack state: ");
-      qleei_print_stack(stack);
-      return false;
+  QLEEI_OP(ADD_NUMBERS) QLEEI_PROVEN_ARITHMETIC(+, QLEEI_OP_ADD);
+  QLEEI_OP(SUB_NUMBERS) QLEEI_PROVEN_ARITHMETIC(-, QLEEI_OP_SUB);
+  QLEEI_OP(MUL_NUMBERS) QLEEI_PROVEN_ARITHMETIC(*, QLEEI_OP_MUL);
+  QLEEI_OP(DIV_NUMBERS) QLEEI_PROVEN_ARITHMETIC(/, QLEEI_OP_DIV);
+
+  QLEEI_OP(ABORT)
+    QLEEI_SPILL();
+    qleei_loc_printfn(QLEEI_OP_TOKEN.loc, "[SYSTEM] ABORTED");
+    qleei_printf("[NOTE] Stack state: ");
+    qleei_print_stack(stack);
+    QLEEI_EXIT(false);
+
+#ifdef QLEEI_THREADED_DISPATCH
+  }
+#else
     }
 
-    qleei_loc_printfn(t.loc, "[ERROR] Unsupported symbol '"QLEEI_SV_Fmt_Str"'", QLEEI_SV_Fmt_Arg(sv));
-    qleei_printf("[INFO] Symbol bytes: [");
-    qleei_sv_iter(c, sv) {
-      if (c > sv.data) qleei_printf(", ");
-      qleei_printf("%d", (int)*c);
+    qleei_printfn("[UNREACHABLE] qleei_execute_op switch (op.kind) case %s", qleei_get_op_kind_name(kind));
+    QLEEI_EXIT(false);
+
+  next:
+    if (single_step) QLEEI_EXIT(true);
+  }
+#endif // QLEEI_THREADED_DISPATCH
+}
+
+#undef QLEEI_OP
+#undef QLEEI_DISPATCH
+#undef QLEEI_NEXT
+#undef QLEEI_EXIT
+#undef QLEEI_OP_TOKEN
+#undef QLEEI_SKIP_FUSED
+#undef QLEEI_GOTO_OP
+#undef QLEEI_SPILL
+#undef QLEEI_FILL
+#undef QLEEI_CACHE
+#undef QLEEI_CACHED_ARITHMETIC
+#undef QLEEI_PROVEN_ARITHMETIC
+
+bool qleei_execute_op(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t *pc, bool inside_of_proc) {
+  return qleei__execute(it, code, pc, inside_of_proc, true);
+}
+
+bool qleei_execute_code(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t *pc, bool inside_of_proc) {
+  return qleei__execute(it, code, pc, inside_of_proc, false);
+}
+
+#ifdef QLEEI_JIT
+// ==================================================
+// JIT
+// --------------------------------------------------
+// Straight-line procedure bodies are translated to x86-64 once the procedure was called QLEEI_JIT_THRESHOLD
+// times. The stack is tracked while compiling: every item lives in a register (XMM for numbers, general purpose
+// for pointers), stack shuffles only move them around at compile time and arithmetic allocates a new register for
+// its result. The generated function takes a pointer to the procedure's inputs on the stack, loads them, runs the
+// body and writes its outputs back in their place.
+// Bodies with jumps, calls, bools or anything that could report an error in the interpreter are never compiled.
+#include <stddef.h>
+#include <sys/mman.h>
+
+#define QLEEI_JIT_MAX_SLOTS 64
+
+#define QLEEI_JIT_RAX 0 // Scratch register
+#define QLEEI_JIT_RDI 7 // Address of the first input item
+
+// Caller saved and usable as a base without a SIB byte, so the generated code never saves anything
+static const int QLEEI_JIT_GPRS[] = { 1, 2, 6, 8, 9, 10, 11 }; // rcx, rdx, rsi, r8, r9, r10, r11
+
+typedef struct {
+  Qleei_Value_Kind kind;
+  int              reg;
+} Qleei_Jit_Slot;
+
+typedef struct {
+  struct {
+    qleei_ui8_t *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } code;
+  bool           out_of_memory;
+  Qleei_Jit_Slot slots[QLEEI_JIT_MAX_SLOTS];
+  qleei_uisz_t   len;
+  qleei_ui8_t    xmm_refs[16];
+  qleei_ui8_t    gpr_refs[16];
+} Qleei_Jit;
+
+static void qleei__jit_byte(Qleei_Jit *j, qleei_ui8_t byte) {
+  if (!qleei_alist_append(&j->code, &byte)) j->out_of_memory = true;
+}
+
+static void qleei__jit_imm32(Qleei_Jit *j, qleei_ui32_t imm) {
+  for (int i = 0; i < 4; ++i) qleei__jit_byte(j, (qleei_ui8_t)(imm >> (i*8)));
+}
+
+// Emits `[prefix] [REX] opcode ModRM [disp32]`, `rm` is a memory operand based on that register when `mem` is set
+static void qleei__jit_op(Qleei_Jit *j, qleei_ui8_t prefix, bool w, const char *opcode, int reg, int rm, bool mem, qleei_si32_t disp) {
+  if (prefix != 0) qleei__jit_byte(j, prefix);
+  qleei_ui8_t rex = 0x40 | (w ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+  if (rex != 0x40) qleei__jit_byte(j, rex);
+  for (const char *c = opcode; *c != 0; ++c) qleei__jit_byte(j, (qleei_ui8_t)*c);
+  if (mem) {
+    qleei__jit_byte(j, 0x80 | ((reg & 7) << 3) | (rm & 7));
+    qleei__jit_imm32(j, (qleei_ui32_t)disp);
+  } else {
+    qleei__jit_byte(j, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+  }
+}
+
+static qleei_si32_t qleei__jit_item_offset(qleei_uisz_t slot, Qleei_Value_Kind kind) {
+  qleei_uisz_t offset = slot * sizeof(Qleei_Value_Item);
+#ifdef QLEEI_NAN_BOXING
+  (void)kind; // Numbers are stored as they are and boxed pointers keep their address in the low bits
+#else
+  if (kind == QLEEI_VALUE_KIND_NUMBER)  offset += offsetof(Qleei_Value_Item, as_number.value);
+  if (kind == QLEEI_VALUE_KIND_POINTER) offset += offsetof(Qleei_Value_Item, as_pointer.value);
+#endif // QLEEI_NAN_BOXING
+  return (qleei_si32_t)offset;
+}
+
+static void qleei__jit_mov_rax_imm64(Qleei_Jit *j, qleei_ui64_t imm) {
+  qleei__jit_byte(j, 0x48); qleei__jit_byte(j, 0xB8); // mov rax, imm64
+  qleei__jit_imm32(j, (qleei_ui32_t)imm); qleei__jit_imm32(j, (qleei_ui32_t)(imm >> 32));
+}
+
+// Loads the item in `slot` of the inputs into `reg`
+static void qleei__jit_load_item(Qleei_Jit *j, qleei_uisz_t slot, Qleei_Value_Kind kind, int reg) {
+  qleei_si32_t offset = qleei__jit_item_offset(slot, kind);
+  if (kind == QLEEI_VALUE_KIND_NUMBER) {
+    qleei__jit_op(j, 0xF2, false, "\x0F\x10", reg, QLEEI_JIT_RDI, true, offset); // movsd reg, [rdi+off]
+    return;
+  }
+  qleei__jit_op(j, 0x00, true, "\x8B", reg, QLEEI_JIT_RDI, true, offset);        // mov reg, [rdi+off]
+#ifdef QLEEI_NAN_BOXING
+  qleei__jit_op(j, 0x00, true, "\xC1", 4, reg, false, 0);                        // shl reg, 16
+  qleei__jit_byte(j, 64 - QLEEI_NAN_BOX_TAG_SHIFT);
+  qleei__jit_op(j, 0x00, true, "\xC1", 5, reg, false, 0);                        // shr reg, 16
+  qleei__jit_byte(j, 64 - QLEEI_NAN_BOX_TAG_SHIFT);
+#endif // QLEEI_NAN_BOXING
+}
+
+// Stores `s` as the item in `slot` of the outputs, the register is left untouched since other slots may share it
+static void qleei__jit_store_item(Qleei_Jit *j, qleei_uisz_t slot, Qleei_Jit_Slot s) {
+  qleei_si32_t offset = qleei__jit_item_offset(slot, s.kind);
+  if (s.kind == QLEEI_VALUE_KIND_NUMBER) {
+    qleei__jit_op(j, 0xF2, false, "\x0F\x11", s.reg, QLEEI_JIT_RDI, true, offset);       // movsd [rdi+off], reg
+  } else {
+#ifdef QLEEI_NAN_BOXING
+    qleei__jit_mov_rax_imm64(j, (QLEEI_NAN_BOX_TAG_NUMBERS + s.kind) << QLEEI_NAN_BOX_TAG_SHIFT);
+    qleei__jit_op(j, 0x00, true, "\x09", s.reg, QLEEI_JIT_RAX, false, 0);                // or rax, reg
+    qleei__jit_op(j, 0x00, true, "\x89", QLEEI_JIT_RAX, QLEEI_JIT_RDI, true, offset);    // mov [rdi+off], rax
+#else
+    qleei__jit_op(j, 0x00, true, "\x89", s.reg, QLEEI_JIT_RDI, true, offset);            // mov [rdi+off], reg
+#endif // QLEEI_NAN_BOXING
+  }
+#ifndef QLEEI_NAN_BOXING
+  qleei__jit_op(j, 0x00, false, "\xC7", 0, QLEEI_JIT_RDI, true, (qleei_si32_t)(slot * sizeof(Qleei_Value_Item))); // mov dword [rdi+off], kind
+  qleei__jit_imm32(j, (qleei_ui32_t)s.kind);
+#endif // QLEEI_NAN_BOXING
+}
+
+static bool qleei__jit_alloc(Qleei_Jit *j, Qleei_Value_Kind kind, int *reg) {
+  if (kind == QLEEI_VALUE_KIND_NUMBER) {
+    for (int r = 0; r < 16; ++r) {
+      if (j->xmm_refs[r] == 0) { *reg = r; return true; }
     }
-    qleei_printfn("]");
-    return false;
+  } else if (kind == QLEEI_VALUE_KIND_POINTER) {
+    for (qleei_uisz_t i = 0; i < sizeof(QLEEI_JIT_GPRS)/sizeof(QLEEI_JIT_GPRS[0]); ++i) {
+      if (j->gpr_refs[QLEEI_JIT_GPRS[i]] == 0) { *reg = QLEEI_JIT_GPRS[i]; return true; }
+    }
+  }
+  return false;
+}
+
+static bool qleei__jit_push(Qleei_Jit *j, Qleei_Value_Kind kind, int reg) {
+  if (j->len >= QLEEI_JIT_MAX_SLOTS) return false;
+  j->slots[j->len++] = (Qleei_Jit_Slot){ .kind = kind, .reg = reg };
+  if (kind == QLEEI_VALUE_KIND_NUMBER) j->xmm_refs[reg] += 1;
+  else                                 j->gpr_refs[reg] += 1;
+  return true;
+}
 
+static void qleei__jit_drop(Qleei_Jit *j, qleei_uisz_t n) {
+  for (qleei_uisz_t i = 0; i < n; ++i) {
+    Qleei_Jit_Slot s = j->slots[--j->len];
+    if (s.kind == QLEEI_VALUE_KIND_NUMBER) j->xmm_refs[s.reg] -= 1;
+    else                                   j->gpr_refs[s.reg] -= 1;
+  }
+}
+
+static Qleei_Jit_Slot *qleei__jit_top(Qleei_Jit *j, qleei_uisz_t depth) {
+  return &j->slots[j->len - 1 - depth];
+}
+
+static bool qleei__jit_arithmetic(Qleei_Jit *j, Qleei_Op_Kind kind) {
+  Qleei_Jit_Slot a = *qleei__jit_top(j, 0);
+  Qleei_Jit_Slot b = *qleei__jit_top(j, 1);
+  int r;
+
+  if (a.kind == QLEEI_VALUE_KIND_NUMBER && b.kind == QLEEI_VALUE_KIND_NUMBER) {
+    const char *opcode = NULL;
+    switch (kind) {
+    case QLEEI_OP_ADD: opcode = "\x0F\x58"; break; // addsd
+    case QLEEI_OP_SUB: opcode = "\x0F\x5C"; break; // subsd
+    case QLEEI_OP_MUL: opcode = "\x0F\x59"; break; // mulsd
+    case QLEEI_OP_DIV: opcode = "\x0F\x5E"; break; // divsd
+    default: return false;
+    }
+    if (!qleei__jit_alloc(j, QLEEI_VALUE_KIND_NUMBER, &r)) return false;
+    qleei__jit_op(j, 0x00, false, "\x0F\x28", r, a.reg, false, 0); // movaps r, a
+    qleei__jit_op(j, 0xF2, false, opcode,     r, b.reg, false, 0); // op r, b
+    qleei__jit_drop(j, 2);
+    return qleei__jit_push(j, QLEEI_VALUE_KIND_NUMBER, r);
+  }
+
+  // Only `+` can mix a pointer with a number without possibly reporting an error
+  if (kind != QLEEI_OP_ADD) return false;
+  Qleei_Jit_Slot ptr, n;
+  if      (a.kind == QLEEI_VALUE_KIND_POINTER && b.kind == QLEEI_VALUE_KIND_NUMBER) { ptr = a; n = b; }
+  else if (a.kind == QLEEI_VALUE_KIND_NUMBER && b.kind == QLEEI_VALUE_KIND_POINTER) { ptr = b; n = a; }
+  else return false;
+  if (!qleei__jit_alloc(j, QLEEI_VALUE_KIND_POINTER, &r)) return false;
+  qleei__jit_op(j, 0xF2, true,  "\x0F\x2C", QLEEI_JIT_RAX, n.reg, false, 0); // cvttsd2si rax, n
+  qleei__jit_op(j, 0x00, true,  "\x89",     ptr.reg, r, false, 0);           // mov r, ptr
+  qleei__jit_op(j, 0x00, true,  "\x01",     QLEEI_JIT_RAX, r, false, 0);     // add r, rax
+  qleei__jit_drop(j, 2);
+  return qleei__jit_push(j, QLEEI_VALUE_KIND_POINTER, r);
+}
+
+static bool qleei__jit_memory(Qleei_Jit *j, Qleei_Word_Handler h) {
+  bool load_ui8  = h == qleei__word_mem_load_ui8;
+  bool load_ui32 = h == qleei__word_mem_load_ui32;
+  bool save_8    = h == qleei__word_mem_save_ui8 || h == qleei__word_mem_save_si8;
+  bool save_ui32 = h == qleei__word_mem_save_ui32;
+
+  if (load_ui8 || load_ui32) {
+    if (j->len < 1) return false;
+    Qleei_Jit_Slot ptr = *qleei__jit_top(j, 0);
+    int r;
+    if (ptr.kind != QLEEI_VALUE_KIND_POINTER) return false;
+    if (!qleei__jit_alloc(j, QLEEI_VALUE_KIND_NUMBER, &r)) return false;
+    if (load_ui8) qleei__jit_op(j, 0x00, false, "\x0F\xB6", QLEEI_JIT_RAX, ptr.reg, true, 0); // movzx eax, byte [ptr]
+    else          qleei__jit_op(j, 0x00, false, "\x8B",     QLEEI_JIT_RAX, ptr.reg, true, 0); // mov eax, dword [ptr]
+    qleei__jit_op(j, 0xF2, true, "\x0F\x2A", r, QLEEI_JIT_RAX, false, 0);                     // cvtsi2sd r, rax
+    qleei__jit_drop(j, 1);
+    return qleei__jit_push(j, QLEEI_VALUE_KIND_NUMBER, r);
+  }
+
+  if (save_8 || save_ui32) {
+    if (j->len < 2) return false;
+    Qleei_Jit_Slot ptr = *qleei__jit_top(j, 0);
+    Qleei_Jit_Slot val = *qleei__jit_top(j, 1);
+    if (ptr.kind != QLEEI_VALUE_KIND_POINTER || val.kind != QLEEI_VALUE_KIND_NUMBER) return false;
+    qleei__jit_op(j, 0xF2, true, "\x0F\x2C", QLEEI_JIT_RAX, val.reg, false, 0);             // cvttsd2si rax, val
+    if (save_8) qleei__jit_op(j, 0x00, false, "\x88", QLEEI_JIT_RAX, ptr.reg, true, 0);      // mov byte [ptr], al
+    else        qleei__jit_op(j, 0x00, false, "\x89", QLEEI_JIT_RAX, ptr.reg, true, 0);      // mov dword [ptr], eax
+    qleei__jit_drop(j, 2);
+    return true;
   }
 
-  qleei_printfn("[UNREACHABLE] qleei_interpreter_step switch (lexer.kind) case %s", qleei_get_token_kind_name(t.kind));
   return false;
 }
 
-bool qleei_execute_proc(Qleei_Interpreter *it, Qleei_Proc *proc) {
-  QLeei_Lexer *l = &it->lexer;
-  QLeei_Lex_Location save_point = qleei_lexer_save_point(l);
+static bool qleei__jit_compile(Qleei_Jit *j, Qleei_Proc *proc) {
+  // Inputs are declared from the top of the stack down, the first one ends up in the highest slot
+  qleei_uisz_t inputs = proc->inputs.len;
+  for (qleei_uisz_t slot = 0; slot < inputs; ++slot) {
+    Qleei_Value_Kind kind = proc->inputs.items[inputs - 1 - slot];
+    int r;
+    if (!qleei__jit_alloc(j, kind, &r)) return false;
+    qleei__jit_load_item(j, slot, kind, r);
+    if (!qleei__jit_push(j, kind, r)) return false;
+  }
 
-  qleei_lexer_restore_point(l, proc->body_start);
+  for (qleei_uisz_t i = 0; i < proc->body.len; ++i) {
+    Qleei_Op *op = &proc->body.items[i];
+    Qleei_Op_Kind kind = qleei__op_base_kind(op->kind);
+    Qleei_Jit_Slot tmp;
+
+    switch (kind) {
+    case QLEEI_OP_PUSH_NUMBER:
+      {
+        qleei_ui64_t bits;
+        int r;
+        qleei_mem_copy(&bits, &op->number, sizeof(bits));
+        if (!qleei__jit_alloc(j, QLEEI_VALUE_KIND_NUMBER, &r)) return false;
+        qleei__jit_mov_rax_imm64(j, bits);
+        qleei__jit_op(j, 0x66, true, "\x0F\x6E", r, QLEEI_JIT_RAX, false, 0);            // movq r, rax
+        if (!qleei__jit_push(j, QLEEI_VALUE_KIND_NUMBER, r)) return false;
+      }
+      break;
+
+    case QLEEI_OP_DUP:
+      if (j->len < 1) return false;
+      tmp = *qleei__jit_top(j, 0);
+      if (!qleei__jit_push(j, tmp.kind, tmp.reg)) return false;
+      break;
+
+    case QLEEI_OP_OVER:
+      if (j->len < 2) return false;
+      tmp = *qleei__jit_top(j, 1);
+      if (!qleei__jit_push(j, tmp.kind, tmp.reg)) return false;
+      break;
+
+    case QLEEI_OP_DROP:
+      if (j->len < 1) return false;
+      qleei__jit_drop(j, 1);
+      break;
+
+    case QLEEI_OP_ROT2:
+      if (j->len < 2) return false;
+      tmp = *qleei__jit_top(j, 0);
+      *qleei__jit_top(j, 0) = *qleei__jit_top(j, 1);
+      *qleei__jit_top(j, 1) = tmp;
+      break;
+
+    case QLEEI_OP_SWAP3:
+      if (j->len < 3) return false;
+      tmp = *qleei__jit_top(j, 0);
+      *qleei__jit_top(j, 0) = *qleei__jit_top(j, 2);
+      *qleei__jit_top(j, 2) = tmp;
+      break;
+
+    case QLEEI_OP_ROT3:
+      if (j->len < 3) return false;
+      tmp = *qleei__jit_top(j, 0);
+      *qleei__jit_top(j, 0) = *qleei__jit_top(j, 1);
+      *qleei__jit_top(j, 1) = *qleei__jit_top(j, 2);
+      *qleei__jit_top(j, 2) = tmp;
+      break;
+
+    case QLEEI_OP_ADD:
+    case QLEEI_OP_SUB:
+    case QLEEI_OP_MUL:
+    case QLEEI_OP_DIV:
+      if (j->len < 2) return false;
+      if (!qleei__jit_arithmetic(j, kind)) return false;
+      break;
 
-  bool ok = true;
-  while ((ok = qleei_lexer_next(l))) {
-    if (qleei_sv_eq_zstr(l->token.string, "end")) break;
-    if (l->token.kind == QLEEI_TOKEN_KIND_EOF) {
-      qleei_loc_printfn(save_point, "[ERROR] Unterminated procedure: Missing 'end' at end of the procedure's body");
-      ok = false;
+    case QLEEI_OP_BUILTIN:
+      if (!qleei__jit_memory(j, QLEEI_BUILTIN_WORDS[op->arg].val.handler)) return false;
       break;
+
+    case QLEEI_OP_RETURN:
+      for (qleei_uisz_t slot = 0; slot < j->len; ++slot) qleei__jit_store_item(j, slot, j->slots[slot]);
+      qleei__jit_byte(j, 0xC3); // ret
+      return !j->out_of_memory;
+
+    default:
+      return false;
     }
-    if (!qleei_execute_token(it, true, l->token)) return false;
   }
 
-  if (ok) qleei_lexer_restore_point(l, save_point);
+  return false;
+}
+
+static bool qleei__jit_install(Qleei_Proc *proc, Qleei_Jit *j) {
+  qleei_uisz_t size = (j->code.len + 4095) & ~(qleei_uisz_t)4095;
+  void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) return false;
+  qleei_mem_copy(mem, j->code.items, j->code.len);
+  if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(mem, size);
+    return false;
+  }
+  proc->jit.fn = (Qleei_Jit_Fn)mem;
+  proc->jit.size = size;
+  proc->jit.outputs = j->len;
+  return true;
+}
+
+static void qleei__jit_proc(Qleei_Proc *proc) {
+  Qleei_Jit j = {0};
+  if (!qleei__jit_compile(&j, proc) || !qleei__jit_install(proc, &j)) proc->jit.failed = true;
+  qleei_alist_free(&j.code);
+}
+
+// The declared inputs are only a guess of what the stack holds, the native code runs only when they match
+static bool qleei__jit_run(Qleei_Interpreter *it, Qleei_Proc *proc) {
+  Qleei_Stack *stack = &it->stack;
+  qleei_uisz_t inputs = proc->inputs.len;
+  if (stack->len < inputs) return false;
+  for (qleei_uisz_t i = 0; i < inputs; ++i) {
+    if (qleei_value_item_kind(stack->items[stack->len - 1 - i]) != proc->inputs.items[i]) return false;
+  }
+  qleei_uisz_t base = stack->len - inputs;
+  if (!qleei_alist_reserve(stack, base + proc->jit.outputs)) return false;
+  proc->jit.fn(&stack->items[base]);
+  stack->len = base + proc->jit.outputs;
+  return true;
+}
+
+// Counts the call and runs the native body if there is one, returns whether it ran
+static bool qleei__jit_call(Qleei_Interpreter *it, Qleei_Proc *proc) {
+  if (proc->jit.fn == NULL && !proc->jit.failed && ++proc->jit.calls >= QLEEI_JIT_THRESHOLD) qleei__jit_proc(proc);
+  return proc->jit.fn != NULL && qleei__jit_run(it, proc);
+}
+
+static void qleei__jit_free(Qleei_Proc *proc) {
+  if (proc->jit.fn != NULL) munmap((void*)proc->jit.fn, proc->jit.size);
+  proc->jit.fn = NULL;
+  proc->jit.size = 0;
+  proc->jit.outputs = 0;
+  proc->jit.calls = 0;
+  proc->jit.failed = false;
+}
+#endif // QLEEI_JIT
+
+bool qleei_execute_proc(Qleei_Interpreter *it, Qleei_Proc *proc) {
+#ifdef QLEEI_JIT
+  if (qleei__jit_call(it, proc)) return true;
+#endif // QLEEI_JIT
 
-  return ok;
+  qleei_uisz_t pc = 0;
+  return qleei_execute_code(it, &proc->body, &pc, true);
 }
 
 bool qleei_interpreter_step(Qleei_Interpreter *it) {
-  if (!qleei_lexer_next(&it->lexer)) return false;
+  if (!it->compiled && !qleei_compile(it)) return false;
 
-  if (!qleei_execute_token(it, false, it->lexer.token)) return false;
+  if (!qleei_execute_op(it, &it->code, &it->pc, false)) return false;
 
   return true;
 }
@@ -2016,59 +5612,107 @@ bool qleei_interpreter_step(Qleei_Interpreter *it) {
 void qleei_interpreter_lexer_init(Qleei_Interpreter *it, const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
   qleei_lexer_init(&it->lexer, input_path, buffer, buf_size);
   it->stack.len = 0;
+  it->code.len = 0;
+  it->code.tokens.len = 0;
+  it->code.calls.len = 0;
+  it->pc = 0;
+  it->compiled = false;
   it->done = false;
 }
 
 void qleei_interpreter_clear(Qleei_Interpreter *it) {
   // Don't feel like adding a qleei_mem_set and this is the answer I came up with to reset the lexer
   it->lexer = (QLeei_Lexer){0};
+  it->tokens.len = 0;
   it->stack.len = 0;
-  it->words.len = 0;
+  qleei_alist_free(&it->words);
   qleei_alist_foreach(Qleei_Proc, proc, &it->procs) {
     proc->inputs.len = 0;
     proc->outputs.len = 0;
+    qleei_code_free(&proc->body);
+#ifdef QLEEI_JIT
+    qleei__jit_free(proc);
+#endif // QLEEI_JIT
   }
-  it->procs.len = 0;
+  qleei_procs_free(&it->procs);
+  qleei_alist_foreach(char *, source, &it->sources) qleei_mem_free(*source);
+  it->sources.len = 0;
+  it->epoch += 1;
+  it->code.len = 0;
+  it->code.tokens.len = 0;
+  it->code.calls.len = 0;
+  it->pc = 0;
+  it->compiled = false;
   it->done = false;
 }
 
 void qleei_interpreter_reset(Qleei_Interpreter *it, const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
   qleei_lexer_init(&it->lexer, input_path, buffer, buf_size);
   it->stack.len = 0;
+  it->code.len = 0;
+  it->code.tokens.len = 0;
+  it->code.calls.len = 0;
+  it->pc = 0;
+  it->compiled = false;
   it->done = false;
   // words registry is intentionally preserved across resets
 }
 
 void qleei_interpreter_free(Qleei_Interpreter *it) {
-  // Free each proc's input/output type lists
+  // Free each proc's input/output type lists and compiled body
   qleei_alist_foreach(Qleei_Proc, proc, &it->procs) {
     qleei_list_free((void**)&proc->inputs.items,  &proc->inputs.cap,  &proc->inputs.len);
     qleei_list_free((void**)&proc->outputs.items, &proc->outputs.cap, &proc->outputs.len);
+    qleei_code_free(&proc->body);
+#ifdef QLEEI_JIT
+    qleei__jit_free(proc);
+#endif // QLEEI_JIT
   }
   qleei_alist_free(&it->stack);
   qleei_alist_free(&it->words);
-  qleei_alist_free(&it->procs);
+  qleei_procs_free(&it->procs);
+  qleei_alist_free(&it->frames);
+  qleei_code_free(&it->code);
+  qleei_tokens_free(&it->tokens);
+  qleei_symbols_free(&it->symbols);
+  qleei_alist_free(&it->lines);
+  qleei_alist_foreach(char *, source, &it->sources) qleei_mem_free(*source);
+  qleei_alist_free(&it->sources);
+}
+
+// Procedures are verified against the callees their names resolve to while compiling, a word registered later
+// must not take one of their names
+static bool qleei__word_name_taken(Qleei_Interpreter *it, const char *word) {
+  Qleei_String_View name = qleei_sv_from_zstr(word);
+  return qleei_builtin_word_exists(name) || qleei_procs_find_by_sv_name(&it->procs, name) != NULL;
 }
 
 bool qleei_interpreter_register_word(Qleei_Interpreter *it, const char *word, Qleei_Word_Handler handler) {
-  if (qleei_builtin_word_exists(qleei_sv_from_zstr(word))) return false;
+  if (qleei__word_name_taken(it, word)) return false;
+  it->epoch += 1;
   return qleei_custom_words_add(&it->words, word, handler, NULL);
 }
 
 bool qleei_interpreter_register_word_with_data(Qleei_Interpreter *it, const char *word, Qleei_Word_Handler handler, void *user_data) {
-  if (qleei_builtin_word_exists(qleei_sv_from_zstr(word))) return false;
+  if (qleei__word_name_taken(it, word)) return false;
+  it->epoch += 1;
   return qleei_custom_words_add(&it->words, word, handler, user_data);
 }
 
+bool qleei_interpreter_register_fast_word(Qleei_Interpreter *it, const char *word, Qleei_Fast_Word_Handler handler, const Qleei_Word_Signature *signature, void *user_data) {
+  if (qleei__word_name_taken(it, word)) return false;
+  it->epoch += 1;
+  return qleei_custom_words_add_fast(&it->words, word, handler, signature, user_data);
+}
+
 bool qleei_interpreter_unregister_word(Qleei_Interpreter *it, const char *word) {
+  it->epoch += 1;
   return qleei_custom_words_remove(&it->words, word);
 }
 
 bool qleei_interpreter_exec(Qleei_Interpreter *it) {
-  while (qleei_interpreter_step(it)) {
-    if (it->done) return true;
-  }
-  return false;
+  if (!it->compiled && !qleei_compile(it)) return false;
+  return qleei_execute_code(it, &it->code, &it->pc, false);
 }
 
 bool qleei_interpret_buffer(const char *buffer_source_path, const char *buffer, qleei_uisz_t buf_size) {
@@ -2089,6 +5733,325 @@ bool qleei_interpret_buffer(const char *buffer_source_path, const char *buffer,
 }
 
 
+// ==================================================
+// Documents
+// --------------------------------------------------
+// Edits only splice the source and widen the range of bytes damaged since it was last lexed. Compiling lexes again
+// from the end of the last token before that range, until a token starts where an old one did past it: the bytes
+// from there on didn't change, so neither did their tokens. A token only depends on its own bytes and the one after
+// it, so the tokens before the range are kept too.
+
+struct Qleei_Document {
+  Qleei_Interpreter it; // Its `tokens` are the tokens of `source` as it was last lexed
+  char *input_path;
+
+  struct {
+    char *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } source;
+
+  // Bytes edited since the tokens were lexed, [start, old_end) of the source they were lexed from became
+  // [start, new_end) of the current one
+  struct {
+    bool         pending;
+    qleei_uisz_t start;
+    qleei_uisz_t old_end;
+    qleei_uisz_t new_end;
+  } damage;
+
+  Qleei_Tokens fresh;   // Tokens lexed again, before they are spliced into `it.tokens`
+  Qleei_Procs previous; // Procedures of the last compilation, taken out of it as they are reused
+  qleei_uisz_t next;    // First entry of `previous` that may still be reused
+  qleei_uisz_t checked; // Procedures defined so far that were compared with the ones they took the place of
+  qleei_uisz_t epoch;   // `epoch` of the interpreter when it was last compiled, words changed if it moved since
+  bool stable;          // Every procedure defined so far looks to the code calling it like the one at its index did
+};
+
+// Like qleei_mem_copy, the regions may overlap
+static void qleei__mem_move(void *dest, const void *src, qleei_uisz_t count) {
+  qleei_ui8_t *d = dest;
+  const qleei_ui8_t *s = src;
+  if (d < s) {
+    for (qleei_uisz_t i = 0; i < count; ++i) d[i] = s[i];
+  } else {
+    for (qleei_uisz_t i = count; i > 0; --i) d[i - 1] = s[i - 1];
+  }
+}
+
+static void qleei__proc_free(Qleei_Proc *proc) {
+  qleei_list_free((void**)&proc->inputs.items,  &proc->inputs.cap,  &proc->inputs.len);
+  qleei_list_free((void**)&proc->outputs.items, &proc->outputs.cap, &proc->outputs.len);
+  qleei_code_free(&proc->body);
+#ifdef QLEEI_JIT
+  qleei__jit_free(proc);
+#endif // QLEEI_JIT
+}
+
+// Undoes what fusing and verifying did to `code`, leaving the instructions it was compiled to
+static void qleei__code_unspecialize(Qleei_Code *code) {
+  qleei_alist_foreach(Qleei_Op, op, code) {
+    Qleei_Op_Kind base = qleei__op_base_kind(op->kind);
+    if (qleei__fused_base_kind(op->kind) != op->kind) {
+      op->arg = 0;
+      if (base != QLEEI_OP_PUSH_NUMBER) op->number = 0;
+    }
+    if (base == QLEEI_OP_CALL) op->arg = 0;
+    op->kind = base;
+  }
+}
+
+Qleei_Document *qleei_document_new(const char *input_path) {
+  Qleei_Document *doc = qleei_mem_alloc(sizeof(Qleei_Document));
+  if (doc == NULL) return NULL;
+  *doc = (Qleei_Document){0};
+  doc->it.document = doc;
+
+  doc->input_path = qleei_zstr_dup(input_path);
+  // The lexer refuses NULL buffers, empty sources still get one
+  if ((input_path != NULL && doc->input_path == NULL) || !qleei_alist_reserve(&doc->source, 1)) {
+    qleei_document_free(doc);
+    return NULL;
+  }
+  return doc;
+}
+
+bool qleei_document_edit(Qleei_Document *doc, qleei_uisz_t start, qleei_uisz_t removed, const char *text, qleei_uisz_t text_len) {
+  qleei_uisz_t len = doc->source.len;
+  if (start > len || removed > len - start) {
+    qleei_printfn("[ERROR] Cannot replace %zu bytes at %zu of a document of %zu bytes", removed, start, len);
+    return false;
+  }
+  if (!qleei_alist_reserve(&doc->source, len - removed + text_len)) return false;
+
+  char *source = doc->source.items;
+  qleei__mem_move(source + start + text_len, source + start + removed, len - start - removed);
+  if (text_len > 0) qleei_mem_copy(source + start, text, text_len);
+  doc->source.len = len - removed + text_len;
+
+  if (!doc->damage.pending) {
+    doc->damage.pending = true;
+    doc->damage.start = start;
+    doc->damage.old_end = start + removed;
+    doc->damage.new_end = start + text_len;
+    return true;
+  }
+  // The damaged range now ends at `end` of the source before this edit, which the earlier edits left untouched
+  // when it is past their range
+  qleei_uisz_t end = start + removed;
+  if (end < doc->damage.new_end) end = doc->damage.new_end;
+  if (start < doc->damage.start) doc->damage.start = start;
+  doc->damage.old_end = end - doc->damage.new_end + doc->damage.old_end;
+  doc->damage.new_end = end - removed + text_len;
+  return true;
+}
+
+// Index of the first token ending at or after `index`
+static qleei_uisz_t qleei__tokens_ending_from(const Qleei_Tokens *tokens, qleei_uisz_t index) {
+  qleei_uisz_t lo = 0, hi = tokens->len;
+  while (lo < hi) {
+    qleei_uisz_t mid = lo + (hi - lo)/2;
+    if ((qleei_uisz_t)tokens->offsets[mid] + tokens->lengths[mid] < index) lo = mid + 1;
+    else                                                                   hi = mid;
+  }
+  return lo;
+}
+
+// Brings the tokens up to date with the source, procedures whose tokens were lexed again can't be reused anymore
+static bool qleei__document_relex(Qleei_Document *doc) {
+  if (!doc->damage.pending) return true;
+  Qleei_Interpreter *it = &doc->it;
+  Qleei_Tokens *tokens = &it->tokens;
+  const char *buffer = doc->source.items;
+  qleei_uisz_t old_end = doc->damage.old_end;
+  qleei_uisz_t new_end = doc->damage.new_end;
+  if (doc->source.len > (qleei_ui32_t)-1) {
+    qleei_printfn("[ERROR] Input of %zu bytes is too large to tokenize", doc->source.len);
+    return false;
+  }
+
+  qleei_uisz_t first = qleei__tokens_ending_from(tokens, doc->damage.start);
+  QLeei_Lexer l;
+  qleei_lexer_init(&l, doc->input_path, buffer, doc->source.len);
+  l.symbols = &it->symbols;
+  qleei__line_starts_forget(&it->lines);
+  l.lines = &it->lines;
+  if (first > 0) l.index = tokens->offsets[first - 1] + tokens->lengths[first - 1];
+
+  Qleei_Tokens *fresh = &doc->fresh;
+  fresh->len = 0;
+  qleei_uisz_t last = first; // One past the old tokens lexed again
+  while (true) {
+    if (!qleei_lexer_next(&l)) return false;
+    if (l.token.kind == QLEEI_TOKEN_KIND_EOF) {
+      last = tokens->len;
+      break;
+    }
+    qleei_uisz_t offset = l.token.string.data - buffer;
+    if (offset >= new_end) {
+      qleei_uisz_t old_offset = offset - new_end + old_end;
+      while (last < tokens->len && tokens->offsets[last] < old_offset) last++;
+      if (last < tokens->len && tokens->offsets[last] == old_offset) break;
+    }
+    if (!qleei__tokens_append(fresh, buffer, &l.token)) return false;
+  }
+
+  qleei_uisz_t removed = last - first;
+  qleei_uisz_t added = fresh->len;
+  qleei_uisz_t len = tokens->len - removed + added;
+  if (len > 0) {
+    if (!qleei__tokens_reserve(tokens, len)) return false;
+    qleei_uisz_t tail = tokens->len - last;
+#define QLEEI__TOKENS_SPLICE(array) \
+    do { \
+      qleei__mem_move(tokens->array + first + added, tokens->array + last, tail*sizeof(*tokens->array)); \
+      if (added > 0) qleei_mem_copy(tokens->array + first, fresh->array, added*sizeof(*tokens->array)); \
+    } while (0)
+    QLEEI__TOKENS_SPLICE(kinds);
+    QLEEI__TOKENS_SPLICE(offsets);
+    QLEEI__TOKENS_SPLICE(lengths);
+    QLEEI__TOKENS_SPLICE(numbers);
+    QLEEI__TOKENS_SPLICE(ids);
+#undef QLEEI__TOKENS_SPLICE
+    for (qleei_uisz_t i = first + added; i < len; ++i) tokens->offsets[i] = (qleei_ui32_t)(tokens->offsets[i] + new_end - old_end);
+  }
+  tokens->len = len;
+
+  qleei_alist_foreach(Qleei_Proc, proc, &it->procs) {
+    if (proc->source.end <= first) continue;
+    if (proc->source.first >= last) {
+      proc->source.first = proc->source.first - removed + added;
+      proc->source.end   = proc->source.end   - removed + added;
+    } else {
+      proc->source.end = 0;
+    }
+  }
+  doc->damage.pending = false;
+  return true;
+}
+
+// Whether verifying calls to `a` and `b` gives the same results
+static bool qleei__proc_same_signature(const Qleei_Proc *a, const Qleei_Proc *b) {
+  if (a->source.name != b->source.name || a->inputs.len != b->inputs.len) return false;
+  for (qleei_uisz_t i = 0; i < a->inputs.len; ++i) {
+    if (a->inputs.items[i] != b->inputs.items[i]) return false;
+  }
+  if (a->effect.known != b->effect.known) return false;
+  if (!a->effect.known) return true;
+  if (a->effect.consumes != b->effect.consumes || a->effect.produces_len != b->effect.produces_len) return false;
+  for (qleei_uisz_t i = 0; i < a->effect.produces_len; ++i) {
+    if (a->effect.produces[i] != b->effect.produces[i]) return false;
+  }
+  return true;
+}
+
+// Takes the procedure starting at the lexer's `proc` token from the last compilation when it was compiled from the
+// same tokens. Its body is verified again unless the procedures before it look the same as when it was verified
+static bool qleei__document_reuse_proc(Qleei_Document *doc, bool *reused) {
+  Qleei_Interpreter *it = &doc->it;
+  QLeei_Lexer *l = &it->lexer;
+  Qleei_Procs *previous = &doc->previous;
+  qleei_uisz_t first = l->cursor - 1;
+  // The ones compiled again since the last reused one
+  for (; doc->checked < it->procs.len; ++doc->checked) {
+    if (doc->checked >= previous->len || !qleei__proc_same_signature(&it->procs.items[doc->checked], &previous->items[doc->checked])) {
+      doc->stable = false;
+    }
+  }
+  while (doc->next < previous->len && (previous->items[doc->next].source.end == 0 || previous->items[doc->next].source.first < first)) {
+    doc->next += 1;
+  }
+  if (l->tokens == NULL || doc->next >= previous->len || previous->items[doc->next].source.first != first) return true;
+
+  qleei_uisz_t index = doc->next++;
+  Qleei_Proc proc = previous->items[index];
+  previous->items[index] = (Qleei_Proc){0};
+  *reused = true;
+
+  // Words may have been registered since
+  if (!qleei_lexer_next(l) || !qleei__proc_name_is_free(it, &l->token)) {
+    qleei__proc_free(&proc);
+    return false;
+  }
+
+  // Edits before the definition moved it in the source, or the source itself
+  qleei_uisz_t offset = it->tokens.offsets[first];
+  if (offset != proc.source.offset || proc.body.tokens.items[0].loc.buffer != l->buffer) {
+    qleei_alist_foreach(QLeei_Token, t, &proc.body.tokens) {
+      t->loc.buffer = l->buffer;
+      t->loc.index = t->loc.index - proc.source.offset + offset;
+      t->string.data = l->buffer + t->loc.index;
+    }
+  }
+  proc.name_sv = l->token.string;
+  proc.source.offset = offset;
+#ifdef QLEEI_JIT
+  qleei__jit_free(&proc); // The machine code may refer to procedures by address
+#endif // QLEEI_JIT
+
+  if (!doc->stable || it->procs.len != index) {
+    doc->stable = false;
+    qleei__code_unspecialize(&proc.body);
+    qleei__fuse_code(&proc.body);
+    proc.effect = (Qleei_Proc){0}.effect;
+    if (!qleei__verify_code(it, &proc.body, &proc)) {
+      qleei__proc_free(&proc);
+      return false;
+    }
+  }
+
+  // Leaves the lexer on the closing `end`, like compiling the body does
+  l->cursor = proc.source.end - 1;
+  if (!qleei_lexer_next(l) || !qleei_procs_append(&it->procs, proc)) {
+    qleei__proc_free(&proc);
+    return false;
+  }
+  it->epoch += 1;
+  doc->checked = it->procs.len;
+  return true;
+}
+
+bool qleei_document_compile(Qleei_Document *doc) {
+  Qleei_Interpreter *it = &doc->it;
+  it->compiled = false;
+  if (!qleei__document_relex(doc)) return false;
+
+  // Procedures are defined again as compiling reaches them. Calls resolved before hold indices into the old list,
+  // moving the epoch makes them resolve again
+  doc->previous = it->procs;
+  it->procs = (Qleei_Procs){0};
+  doc->next = 0;
+  doc->checked = 0;
+  doc->stable = it->epoch == doc->epoch;
+  it->epoch += 1;
+
+  qleei_lexer_init_tokens(&it->lexer, doc->input_path, doc->source.items, doc->source.len, &it->tokens);
+  it->lexer.symbols = &it->symbols;
+  it->stack.len = 0;
+  it->frames.len = 0;
+  it->done = false;
+  bool result = qleei_compile(it);
+
+  qleei_alist_foreach(Qleei_Proc, proc, &doc->previous) qleei__proc_free(proc);
+  qleei_procs_free(&doc->previous);
+  doc->epoch = it->epoch;
+  return result;
+}
+
+Qleei_Interpreter *qleei_document_interpreter(Qleei_Document *doc) {
+  return &doc->it;
+}
+
+void qleei_document_free(Qleei_Document *doc) {
+  if (doc == NULL) return;
+  qleei_interpreter_free(&doc->it);
+  qleei_tokens_free(&doc->fresh);
+  qleei_alist_free(&doc->source);
+  if (doc->input_path != NULL) qleei_mem_free(doc->input_path);
+  qleei_mem_free(doc);
+}
+
+
 #ifdef PLATFORM_DESKTOP
 #include <stdio.h>
 #include <stdlib.h>
@@ -2110,14 +6073,11 @@ void qleei_printfn(const char *fmt, ...) {
   putchar('\n');
 }
 
-double qleei_parse_number(Qleei_String_View sv) {
-  char buffer[sv.len+1];
-  memcpy(buffer, sv.data, sv.len);
-  buffer[sv.len] = 0;
-  return atof((const char *)buffer);
+void *qleei_mem_alloc(qleei_uisz_t size) {
+  return malloc(size);
 }
 
-void *qleei_mem_alloc(qleei_uisz_t size) {
+void *qleei_program_mem_alloc(qleei_uisz_t size) {
   return malloc(size);
 }
 
@@ -2137,45 +6097,1374 @@ qleei_uisz_t qleei_zstr_len(const char *zstr) {
   return strlen(zstr);
 }
 
+// ==================================================
+// Ahead of time translation to C
+// --------------------------------------------------
+// Every instruction becomes a C statement: jumps become `goto`s, procedures become functions and the common stack
+// operations are written inline. Anything that may report an error, call a word or that is not worth inlining runs
+// through qleei_execute_op on a copy of the compiled code that is embedded in the generated file, so the translated
+// program behaves and reports errors exactly like the interpreter. Procedures call each other on the C stack, every
+// call counts towards QLEEI_MAX_CALL_DEPTH including the tail calls the interpreter doesn't nest, and the stack the
+// binary runs on must have room for that many calls.
+
+static void qleei__aot_string(FILE *out, const char *data, qleei_uisz_t len) {
+  fputc('"', out);
+  for (qleei_uisz_t i = 0; i < len; ++i) {
+    unsigned char c = (unsigned char)data[i];
+    if (c == '"' || c == '\\')   fprintf(out, "\\%c", c);
+    else if (c < 32 || c >= 127) fprintf(out, "\\%03o", c);
+    else                         fputc(c, out);
+  }
+  fputc('"', out);
+}
 
-#endif // PLATFORM_DESKTOP
+static void qleei__aot_number(FILE *out, double number) {
+  if (number != number)            fprintf(out, "__builtin_nan(\"\")");
+  else if (number - number != 0.0) fprintf(out, "%s__builtin_inf()", number < 0 ? "-" : "");
+  else                             fprintf(out, "%a", number);
+}
 
-#ifdef PLATFORM_BROWSER
+static void qleei__aot_code_data(FILE *out, Qleei_Code *code, const char *name) {
+  fprintf(out, "static Qleei_Op %s_ops[] = {\n", name);
+  qleei_alist_foreach(Qleei_Op, op, code) {
+    // The generated code runs every instruction of a fused sequence by itself
+    fprintf(out, "  { QLEEI_OP_%s, %zu, ", qleei_get_op_kind_name(qleei__op_base_kind(op->kind)), op->arg);
+    qleei__aot_number(out, op->number);
+    fprintf(out, " },\n");
+  }
+  fprintf(out, "};\n");
+
+  // Designated so that fields tokens and locations gain later start as zero. Ids belong to the translating
+  // interpreter's symbols, the program's interpreter has none of them and resolves the names by their string instead
+  fprintf(out, "static QLeei_Token %s_tokens[] = {\n", name);
+  qleei_alist_foreach(QLeei_Token, t, &code->tokens) {
+    fprintf(out, "  { .kind = (Qleei_Token_Kind)%d, .loc = { .file_path = QLEEI_AOT_FILE, .buffer = qleei_aot_source, .index = %zu }, .string = { ", (int)t->kind, t->loc.index);
+    qleei__aot_string(out, t->string.data, t->string.len);
+    fprintf(out, ", %zu }, .number = ", t->string.len);
+    qleei__aot_number(out, t->number);
+    fprintf(out, ", .symbol = %d, .id = QLEEI_SYMBOL_NONE },\n", (int)t->symbol);
+  }
+  fprintf(out, "};\n");
 
-qleei_uisz_t qleei_zstr_len(const char *zstr) {
-  qleei_uisz_t len = 0;
-  char c;
-  while ((c = zstr[len++]) != 0) { }
-  len--;
-  return len;
-}
+  fprintf(out, "static Qleei_Call_Cache %s_calls[%zu];\n", name, code->len);
 
-double qleei_parse_number(Qleei_String_View sv) {
-  return qleei_wasm_parse_number((const char *)sv.data, sv.len);
+  fprintf(out, "static Qleei_Code %s = { %s_ops, %zu, %zu, { %s_tokens, %zu, %zu }, { %s_calls, %zu, %zu } };\n\n",
+          name, name, code->len, code->len, name, code->len, code->len, name, code->len, code->len);
 }
 
-void *qleei_mem_alloc(qleei_uisz_t size) {
-  return qleei_wasm_malloc(size);
+// Procedure a call instruction is translated into a direct call of, NULL if it runs through qleei_execute_op
+static Qleei_Proc *qleei__aot_called_proc(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t i) {
+  QLeei_Token *t = &code->tokens.items[i];
+  if (qleei__op_base_kind(code->items[i].kind) != QLEEI_OP_CALL) return NULL;
+  if (qleei__find_word(it, t) != NULL) return NULL;
+  return qleei__find_proc(it, t);
 }
 
-void *qleei_mem_realloc(void *ptr, qleei_uisz_t size) {
-  return qleei_wasm_mrealloc(ptr, size);
+// Sets `calls` if `code` has a direct call, which the depth counter is emitted for, and `checks_inputs` if one of them
+// checks its inputs at run time, which the procedure table is emitted for
+static void qleei__aot_scan_calls(Qleei_Interpreter *it, Qleei_Code *code, bool *calls, bool *checks_inputs) {
+  for (qleei_uisz_t i = 0; i < code->len; ++i) {
+    Qleei_Proc *proc = qleei__aot_called_proc(it, code, i);
+    if (proc == NULL) continue;
+    *calls = true;
+    if (code->items[i].arg != (qleei_uisz_t)(proc - it->procs.items) + 1) *checks_inputs = true;
+  }
 }
 
-void qleei_mem_free(void *ptr) {
-  qleei_wasm_mfree(ptr);
+// Arithmetic the verifier proved to only see numbers has nothing to check
+static void qleei__aot_arithmetic(FILE *out, Qleei_Op *op, qleei_uisz_t i, const char *operator) {
+  bool proven = op->kind == QLEEI_OP_ADD_NUMBERS || op->kind == QLEEI_OP_SUB_NUMBERS ||
+                op->kind == QLEEI_OP_MUL_NUMBERS || op->kind == QLEEI_OP_DIV_NUMBERS;
+  if (proven) fprintf(out, "  QLEEI_AOT_NUMBERS(%s);\n", operator);
+  else        fprintf(out, "  QLEEI_AOT_ARITHMETIC(%zu, %s);\n", i, operator);
 }
 
-void *qleei_mem_copy(void *dest, const void *src, qleei_uisz_t count) {
-  char *dbuf = (char*)dest;
-  const char *sbuf = (const char *)src;
-  for (qleei_uisz_t i = 0; i < count; ++i) {
-    *dbuf = *sbuf;
-    dbuf++;
-    sbuf++;
+static bool qleei__aot_code_function(FILE *out, Qleei_Interpreter *it, Qleei_Code *code, const char *data, const char *function, bool inside_of_proc) {
+  bool *targets = qleei_mem_alloc(code->len + 1);
+  if (targets == NULL) return false;
+  for (qleei_uisz_t i = 0; i <= code->len; ++i) targets[i] = false;
+  qleei_alist_foreach(Qleei_Op, op, code) {
+    if (op->kind == QLEEI_OP_JUMP || op->kind == QLEEI_OP_JUMP_UNLESS || op->kind == QLEEI_OP_JUMP_IF) targets[op->arg] = true;
   }
-  return dest;
-}
+
+  fprintf(out, "%sbool %s(Qleei_Interpreter *it) {\n", inside_of_proc ? "static " : "", function);
+  fprintf(out, "  Qleei_Stack *stack = &it->stack;\n");
+  fprintf(out, "  Qleei_Code *code = &%s;\n", data);
+  fprintf(out, "  const bool inside_of_proc = %s;\n", inside_of_proc ? "true" : "false");
+  fprintf(out, "  (void)stack; (void)code; (void)inside_of_proc;\n");
+
+  for (qleei_uisz_t i = 0; i < code->len; ++i) {
+    Qleei_Op *op = &code->items[i];
+    QLeei_Token *t = &code->tokens.items[i];
+    if (targets[i]) fprintf(out, "L%zu:;\n", i);
+    fprintf(out, "  // %s "QLEEI_SV_Fmt_Str"\n", qleei_get_op_kind_name(op->kind), QLEEI_SV_Fmt_Arg(t->string));
+
+    switch (qleei__op_base_kind(op->kind)) {
+    case QLEEI_OP_PUSH_NUMBER:
+      fprintf(out, "  qleei_stack_push(stack, qleei_value_item_from_number(");
+      qleei__aot_number(out, op->number);
+      fprintf(out, "));\n");
+      break;
+    case QLEEI_OP_PUSH_BOOL:
+      fprintf(out, "  qleei_stack_push(stack, qleei_value_item_from_bool(%s));\n", op->number == 1.0 ? "true" : "false");
+      break;
+    case QLEEI_OP_DUP:
+      fprintf(out, "  if (stack->len >= 1) qleei_stack_push(stack, QLEEI_AOT_TOP(0)); else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_OVER:
+      fprintf(out, "  if (stack->len >= 2) qleei_stack_push(stack, QLEEI_AOT_TOP(1)); else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_DROP:
+      fprintf(out, "  if (stack->len >= 1) stack->len -= 1; else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_ROT2:
+      fprintf(out, "  if (stack->len >= 2) QLEEI_AOT_SWAP(0, 1); else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_SWAP3:
+      fprintf(out, "  if (stack->len >= 3) QLEEI_AOT_SWAP(0, 2); else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_ROT3:
+      fprintf(out, "  if (stack->len >= 3) { QLEEI_AOT_SWAP(0, 2); QLEEI_AOT_SWAP(0, 1); } else QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    case QLEEI_OP_ADD: qleei__aot_arithmetic(out, op, i, "+"); break;
+    case QLEEI_OP_SUB: qleei__aot_arithmetic(out, op, i, "-"); break;
+    case QLEEI_OP_MUL: qleei__aot_arithmetic(out, op, i, "*"); break;
+    case QLEEI_OP_DIV: qleei__aot_arithmetic(out, op, i, "/"); break;
+    case QLEEI_OP_JUMP:
+      fprintf(out, "  goto L%zu;\n", op->arg);
+      break;
+    case QLEEI_OP_JUMP_UNLESS:
+    case QLEEI_OP_JUMP_IF:
+      fprintf(out, "  if (stack->len == 0) QLEEI_AOT_OP(%zu);\n", i);
+      fprintf(out, "  if (%sqleei_value_item_as_bool(stack->items[--stack->len])) goto L%zu;\n", op->kind == QLEEI_OP_JUMP_UNLESS ? "!" : "", op->arg);
+      break;
+    case QLEEI_OP_CALL:
+      {
+        Qleei_Proc *proc = qleei__aot_called_proc(it, code, i);
+        if (proc == NULL) {
+          fprintf(out, "  QLEEI_AOT_OP(%zu);\n", i);
+          break;
+        }
+        qleei_uisz_t index = proc - it->procs.items;
+        if (op->arg != index + 1) {
+          fprintf(out, "  if (!qleei_proc_check_inputs(&qleei_aot_procs[%zu], stack, code->tokens.items[%zu])) return false;\n", index, i);
+        }
+        fprintf(out, "  QLEEI_AOT_CALL(%zu, %zu);\n", index, i);
+      }
+      break;
+    case QLEEI_OP_RETURN:
+      fprintf(out, "  return true;\n");
+      break;
+    case QLEEI_OP_HALT:
+      fprintf(out, "  it->done = true;\n  return true;\n");
+      break;
+    default:
+      fprintf(out, "  QLEEI_AOT_OP(%zu);\n", i);
+      break;
+    }
+  }
+  if (targets[code->len]) fprintf(out, "L%zu:;\n", code->len);
+  fprintf(out, "  return true;\n}\n\n");
+
+  qleei_mem_free(targets);
+  return true;
+}
+
+bool qleei_translate_to_c(Qleei_Interpreter *it, FILE *out) {
+  if (!it->compiled && !qleei_compile(it)) return false;
+
+  bool calls = false, checks_inputs = false;
+  qleei__aot_scan_calls(it, &it->code, &calls, &checks_inputs);
+  for (qleei_uisz_t p = 0; p < it->procs.len; ++p) qleei__aot_scan_calls(it, &it->procs.items[p].body, &calls, &checks_inputs);
+
+  char name[64];
+  fprintf(out, "// Generated by qleei from %s, link it with a build of qleei.m32.c that defines QLEEI_AOT\n", it->lexer.input_path);
+  fprintf(out, "#define PLATFORM_DESKTOP\n");
+  fprintf(out, "#include \"qleei.h\"\n\n");
+  fprintf(out, "#define QLEEI_AOT_FILE ");
+  qleei__aot_string(out, it->lexer.input_path, qleei_zstr_len(it->lexer.input_path));
+  fprintf(out, "\n");
+  // Locations of the tokens are offsets into the source, their line and column are found when reporting errors
+  fprintf(out, "static const char qleei_aot_source[] = ");
+  qleei__aot_string(out, it->lexer.buffer, it->lexer.buffer_len);
+  fprintf(out, ";\n");
+  fprintf(out, "#define QLEEI_AOT_TOP(n) (stack->items[stack->len - 1 - (n)])\n");
+  fprintf(out, "#define QLEEI_AOT_SWAP(a, b) do { Qleei_Value_Item tmp = QLEEI_AOT_TOP(a); QLEEI_AOT_TOP(a) = QLEEI_AOT_TOP(b); QLEEI_AOT_TOP(b) = tmp; } while (0)\n");
+  fprintf(out, "#define QLEEI_AOT_OP(i) do { qleei_uisz_t pc = (i); if (!qleei_execute_op(it, code, &pc, inside_of_proc)) return false; } while (0)\n");
+  fprintf(out, "#define QLEEI_AOT_ARITHMETIC(i, op) \\\n");
+  fprintf(out, "  if (stack->len >= 2 && qleei_value_item_kind(QLEEI_AOT_TOP(0)) == QLEEI_VALUE_KIND_NUMBER && qleei_value_item_kind(QLEEI_AOT_TOP(1)) == QLEEI_VALUE_KIND_NUMBER) { \\\n");
+  fprintf(out, "    QLEEI_AOT_TOP(1) = qleei_value_item_from_number(qleei_value_item_number(QLEEI_AOT_TOP(0)) op qleei_value_item_number(QLEEI_AOT_TOP(1))); \\\n");
+  fprintf(out, "    stack->len -= 1; \\\n");
+  fprintf(out, "  } else QLEEI_AOT_OP(i)\n");
+  fprintf(out, "#define QLEEI_AOT_NUMBERS(op) \\\n");
+  fprintf(out, "  do { QLEEI_AOT_TOP(1) = qleei_value_item_from_number(qleei_value_item_number(QLEEI_AOT_TOP(0)) op qleei_value_item_number(QLEEI_AOT_TOP(1))); stack->len -= 1; } while (0)\n");
+  // Calls nest on the C stack, they fail past the same depth as in the interpreter
+  if (calls) fprintf(out, "static qleei_uisz_t qleei_aot_depth = 0;\n");
+  fprintf(out, "#define QLEEI_AOT_CALL(p, i) \\\n");
+  fprintf(out, "  do { \\\n");
+  fprintf(out, "    if (qleei_aot_depth >= QLEEI_MAX_CALL_DEPTH) { \\\n");
+  fprintf(out, "      qleei_loc_printfn(code->tokens.items[(i)].loc, \"[ERROR] Too many nested procedure calls, the limit is %%d\", QLEEI_MAX_CALL_DEPTH); \\\n");
+  fprintf(out, "      return false; \\\n");
+  fprintf(out, "    } \\\n");
+  fprintf(out, "    qleei_aot_depth += 1; \\\n");
+  fprintf(out, "    bool ok = qleei_aot_proc_##p(it); \\\n");
+  fprintf(out, "    qleei_aot_depth -= 1; \\\n");
+  fprintf(out, "    if (!ok) return false; \\\n");
+  fprintf(out, "  } while (0)\n\n");
+
+  // The procedure table and the inputs it points to are only emitted when a call checks the inputs
+  for (qleei_uisz_t p = 0; p < it->procs.len; ++p) {
+    Qleei_Proc *proc = &it->procs.items[p];
+    snprintf(name, sizeof(name), "qleei_aot_proc_%zu_code", p);
+    qleei__aot_code_data(out, &proc->body, name);
+    if (checks_inputs && proc->inputs.len > 0) {
+      fprintf(out, "static Qleei_Value_Kind qleei_aot_proc_%zu_inputs[] = {", p);
+      for (qleei_uisz_t i = 0; i < proc->inputs.len; ++i) fprintf(out, " %d,", (int)proc->inputs.items[i]);
+      fprintf(out, " };\n\n");
+    }
+  }
+  qleei__aot_code_data(out, &it->code, "qleei_aot_main_code");
+
+  if (checks_inputs) {
+    fprintf(out, "static Qleei_Proc qleei_aot_procs[] = {\n");
+    for (qleei_uisz_t p = 0; p < it->procs.len; ++p) {
+      Qleei_Proc *proc = &it->procs.items[p];
+      fprintf(out, "  { .name_sv = { ");
+      qleei__aot_string(out, proc->name_sv.data, proc->name_sv.len);
+      fprintf(out, ", %zu }, ", proc->name_sv.len);
+      if (proc->inputs.len > 0) fprintf(out, ".inputs = { qleei_aot_proc_%zu_inputs, %zu, %zu } },\n", p, proc->inputs.len, proc->inputs.len);
+      else                      fprintf(out, "},\n");
+    }
+    fprintf(out, "};\n\n");
+  }
+  if (it->procs.len > 0) {
+    for (qleei_uisz_t p = 0; p < it->procs.len; ++p) fprintf(out, "static bool qleei_aot_proc_%zu(Qleei_Interpreter *it);\n", p);
+    fprintf(out, "\n");
+  }
+
+  char function[64];
+  for (qleei_uisz_t p = 0; p < it->procs.len; ++p) {
+    snprintf(name, sizeof(name), "qleei_aot_proc_%zu_code", p);
+    snprintf(function, sizeof(function), "qleei_aot_proc_%zu", p);
+    if (!qleei__aot_code_function(out, it, &it->procs.items[p].body, name, function, true)) return false;
+  }
+  return qleei__aot_code_function(out, it, &it->code, "qleei_aot_main_code", "qleei_aot_main", false);
+}
+
+// ==================================================
+// Streaming execution
+// --------------------------------------------------
+// The input is collected in a buffer that only holds the part still being read. Once a line leaves no `while` loop or
+// procedure open, and everything read so far only names words and procedures that are defined by then, everything up
+// to it is copied out, compiled and executed, and the rest moves to the front of the buffer. The copy is freed when
+// the next part runs unless it defined procedures, whose code points into it. Where the input is cut only depends on
+// its lines, not on how much of it each read returned.
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef QLEEI_STREAM_CHUNK_SIZE
+#  define QLEEI_STREAM_CHUNK_SIZE (64*1024) // Bytes requested from the file descriptor at a time
+#endif
+
+// A word of the input not run yet, by offset since the buffer holding it moves as it grows
+typedef struct {
+  qleei_uisz_t offset;
+  qleei_uisz_t len;
+} Qleei__Stream_Name;
+
+typedef struct {
+  Qleei__Stream_Name *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei__Stream_Names;
+
+// What the lines read but not run yet open and name
+typedef struct {
+  qleei_uisz_t depth;             // `while` loops and procedures open
+  bool naming;                    // The last word was `proc`, the next one is the name of a procedure
+  Qleei__Stream_Names defined;    // Procedures the lines define
+  Qleei__Stream_Names unresolved; // Words that name nothing defined so far, a part calling them has to wait
+} Qleei__Stream_Scan;
+
+static bool qleei__stream_names_has(const Qleei__Stream_Names *names, const char *pending, Qleei_String_View word) {
+  qleei_alist_foreach(Qleei__Stream_Name, name, names) {
+    if (qleei_sv_eq_sv((Qleei_String_View){ .data = pending + name->offset, .len = name->len }, word)) return true;
+  }
+  return false;
+}
+
+// Keeps the names at or past `run`, moved to where they are once the part before it was run
+static void qleei__stream_names_shift(Qleei__Stream_Names *names, qleei_uisz_t run) {
+  qleei_uisz_t kept = 0;
+  qleei_alist_foreach(Qleei__Stream_Name, name, names) {
+    if (name->offset < run) continue;
+    names->items[kept++] = (Qleei__Stream_Name){ .offset = name->offset - run, .len = name->len };
+  }
+  names->len = kept;
+}
+
+static bool qleei__stream_word(Qleei_Interpreter *it, Qleei__Stream_Scan *scan, const char *pending, Qleei_String_View word) {
+  qleei_ui32_t id = qleei__keyword_symbol(word);
+  if (id == QLEEI_SYMBOL_WHILE || id == QLEEI_SYMBOL_PROC) scan->depth += 1;
+  else if (id == QLEEI_SYMBOL_END && scan->depth > 0) scan->depth -= 1;
+  if (id != QLEEI_SYMBOL_NONE) {
+    scan->naming = id == QLEEI_SYMBOL_PROC;
+    return true;
+  }
+
+  Qleei__Stream_Name name = { .offset = word.data - pending, .len = word.len };
+  if (scan->naming) {
+    scan->naming = false;
+    // Calls read before the definition can run now
+    qleei_uisz_t kept = 0;
+    qleei_alist_foreach(Qleei__Stream_Name, other, &scan->unresolved) {
+      if (!qleei_sv_eq_sv((Qleei_String_View){ .data = pending + other->offset, .len = other->len }, word)) scan->unresolved.items[kept++] = *other;
+    }
+    scan->unresolved.len = kept;
+    return qleei_alist_append(&scan->defined, &name);
+  }
+
+  bool known = qleei_builtin_word_exists(word) || qleei__custom_words_find(&it->words, word) != NULL ||
+               qleei_procs_find_by_sv_name(&it->procs, word) != NULL || qleei__stream_names_has(&scan->defined, pending, word);
+  if (known) return true;
+  return qleei_alist_append(&scan->unresolved, &name);
+}
+
+// Goes through the words of the line at [start, end) of `pending`. Skips numbers, char literals and comments the way
+// qleei_lexer_next does so only whole identifiers count
+static bool qleei__stream_line(Qleei_Interpreter *it, Qleei__Stream_Scan *scan, const char *pending, qleei_uisz_t start, qleei_uisz_t end) {
+  qleei_uisz_t i = start;
+  while (i < end) {
+    char c = pending[i];
+    if (qleei_is_number_char(c)) {
+      bool decimal = false;
+      while (i < end && (qleei_is_number_char(pending[i]) || (pending[i] == '.' && !decimal))) {
+        if (pending[i] == '.') decimal = true;
+        i++;
+      }
+    } else if (qleei_is_identifier_start_char(c)) {
+      Qleei_String_View word = { .data = pending + i, .len = 0 };
+      while (i < end && qleei_is_identifier_char(pending[i])) i++;
+      word.len = (pending + i) - word.data;
+      if (!qleei__stream_word(it, scan, pending, word)) return false;
+    } else if (c == '\'') {
+      i += 3;
+    } else if (c == '/' && i + 1 < end && pending[i + 1] == '/') {
+      return true;
+    } else {
+      i++;
+    }
+  }
+  return true;
+}
+
+// Compiles and executes one part of the input, which starts after `line_base` lines
+static bool qleei__stream_run(Qleei_Interpreter *it, const char *input_path, const char *text, qleei_uisz_t len, qleei_uisz_t line_base, bool *retained) {
+  // The previous part is no longer needed unless it defined procedures
+  if (!*retained && it->sources.len > 0) qleei_mem_free(it->sources.items[--it->sources.len]);
+
+  char *source = qleei_mem_alloc(len > 0 ? len : 1);
+  if (source == NULL) return false;
+  qleei_mem_copy(source, text, len);
+  if (!qleei_alist_append(&it->sources, &source)) {
+    qleei_mem_free(source);
+    return false;
+  }
+
+  qleei_uisz_t procs = it->procs.len;
+  qleei_lexer_init(&it->lexer, input_path, source, len);
+  it->lexer.line_base = line_base;
+  it->code.len = 0;
+  it->code.tokens.len = 0;
+  it->code.calls.len = 0;
+  it->pc = 0;
+  it->compiled = false;
+  it->done = false;
+  bool result = qleei_interpreter_exec(it);
+  *retained = it->procs.len > procs;
+  return result;
+}
+
+bool qleei_interpreter_exec_fd(Qleei_Interpreter *it, const char *input_path, int fd) {
+  struct {
+    char *items;
+    qleei_uisz_t len;
+    qleei_uisz_t cap;
+  } pending = {0};
+  qleei_uisz_t scanned = 0;   // Bytes of `pending` whose lines went through `scan`
+  qleei_uisz_t cut = 0;       // End of the last line that left nothing open or waiting for a definition
+  Qleei__Stream_Scan scan = {0};
+  qleei_uisz_t line_base = 0; // Lines of the input that came before `pending`
+  bool retained = true;       // Whether the last part run defined procedures
+  bool eof = false;
+  bool result = true;
+
+  while (result && !eof) {
+    if (!qleei_alist_reserve(&pending, pending.len + QLEEI_STREAM_CHUNK_SIZE)) {
+      result = false;
+      break;
+    }
+    ssize_t n = read(fd, pending.items + pending.len, QLEEI_STREAM_CHUNK_SIZE);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      qleei_printfn("[ERROR] Could not read %s: %s", input_path != NULL ? input_path : "the input", strerror(errno));
+      result = false;
+      break;
+    }
+    if (n == 0) eof = true;
+    pending.len += n;
+
+    // Only whole lines are counted, the last one may still be missing its end
+    while (scanned < pending.len) {
+      qleei_uisz_t line_end = qleei__scan_line_end(pending.items, scanned, pending.len);
+      if (line_end == pending.len && !eof) break;
+      if (!qleei__stream_line(it, &scan, pending.items, scanned, line_end)) {
+        result = false;
+        break;
+      }
+      scanned = line_end < pending.len ? line_end + 1 : pending.len;
+      if (scan.depth == 0 && scan.unresolved.len == 0) cut = scanned;
+    }
+    if (!result) break;
+
+    // At the end of the input whatever is left runs too, so the compiler reports anything left open
+    qleei_uisz_t run = eof ? pending.len : cut;
+    if (run == 0) continue;
+    result = qleei__stream_run(it, input_path, pending.items, run, line_base, &retained);
+
+    for (qleei_uisz_t i = qleei__scan_line_end(pending.items, 0, run); i < run; i = qleei__scan_line_end(pending.items, i + 1, run)) {
+      line_base++;
+    }
+    for (qleei_uisz_t i = run; i < pending.len; ++i) pending.items[i - run] = pending.items[i];
+    pending.len -= run;
+    scanned -= run;
+    cut = 0;
+    qleei__stream_names_shift(&scan.defined, run);
+    qleei__stream_names_shift(&scan.unresolved, run);
+  }
+
+  qleei_alist_free(&scan.defined);
+  qleei_alist_free(&scan.unresolved);
+  qleei_alist_free(&pending);
+  return result;
+}
+
+
+#endif // PLATFORM_DESKTOP
+
+#ifdef PLATFORM_BROWSER
+
+qleei_uisz_t qleei_zstr_len(const char *zstr) {
+  qleei_uisz_t len = 0;
+  char c;
+  while ((c = zstr[len++]) != 0) { }
+  len--;
+  return len;
+}
+
+void *qleei_mem_alloc(qleei_uisz_t size) {
+  return qleei_wasm_malloc(size);
+}
+
+void *qleei_program_mem_alloc(qleei_uisz_t size) {
+  return qleei_wasm_program_malloc(size);
+}
+
+void *qleei_mem_realloc(void *ptr, qleei_uisz_t size) {
+  return qleei_wasm_mrealloc(ptr, size);
+}
+
+void qleei_mem_free(void *ptr) {
+  qleei_wasm_mfree(ptr);
+}
+
+void *qleei_mem_copy(void *dest, const void *src, qleei_uisz_t count) {
+  char *dbuf = (char*)dest;
+  const char *sbuf = (const char *)src;
+  for (qleei_uisz_t i = 0; i < count; ++i) {
+    *dbuf = *sbuf;
+    dbuf++;
+    sbuf++;
+  }
+  return dest;
+}
+
+// Programs are translated to their own module working directly on the interpreter's memory. Whatever isn't
+// inlined, and every slow path that may report an error, goes back to the interpreter one instruction at a time
+
+#define QLEEI__WASM_OFFSET(T, member) ((qleei_ui32_t)__builtin_offsetof(T, member))
+#define QLEEI__WASM_ADDRESS(ptr)      ((qleei_si32_t)(qleei_uisz_t)(ptr))
+#define QLEEI__WASM_ITEM_SIZE         ((qleei_si32_t)sizeof(Qleei_Value_Item))
+#define QLEEI__WASM_ITEM_WORDS        (sizeof(Qleei_Value_Item) / 8)
+#ifdef QLEEI_NAN_BOXING
+// Numbers are stored as they are, the value of a boxed bool or pointer is in the low bytes of the item
+#  define QLEEI__WASM_NUMBER_OFFSET   0
+#  define QLEEI__WASM_BOOL_OFFSET     0
+#  define QLEEI__WASM_POINTER_OFFSET  0
+#else
+#  define QLEEI__WASM_NUMBER_OFFSET   QLEEI__WASM_OFFSET(Qleei_Value_Item, as_number.value)
+#  define QLEEI__WASM_BOOL_OFFSET     QLEEI__WASM_OFFSET(Qleei_Value_Item, as_bool.value)
+#  define QLEEI__WASM_POINTER_OFFSET  QLEEI__WASM_OFFSET(Qleei_Value_Item, as_pointer.value)
+#endif // QLEEI_NAN_BOXING
+
+enum {
+  QLEEI__WASM_UNREACHABLE = 0x00,
+  QLEEI__WASM_BLOCK       = 0x02,
+  QLEEI__WASM_LOOP        = 0x03,
+  QLEEI__WASM_IF          = 0x04,
+  QLEEI__WASM_ELSE        = 0x05,
+  QLEEI__WASM_END         = 0x0B,
+  QLEEI__WASM_BR          = 0x0C,
+  QLEEI__WASM_BR_IF       = 0x0D,
+  QLEEI__WASM_RETURN      = 0x0F,
+  QLEEI__WASM_CALL        = 0x10,
+  QLEEI__WASM_LOCAL_GET   = 0x20,
+  QLEEI__WASM_LOCAL_SET   = 0x21,
+  QLEEI__WASM_GLOBAL_GET  = 0x23,
+  QLEEI__WASM_GLOBAL_SET  = 0x24,
+  QLEEI__WASM_I32_LOAD    = 0x28,
+  QLEEI__WASM_I64_LOAD    = 0x29,
+  QLEEI__WASM_F64_LOAD    = 0x2B,
+  QLEEI__WASM_I32_LOAD8_U = 0x2D,
+  QLEEI__WASM_I32_STORE   = 0x36,
+  QLEEI__WASM_I64_STORE   = 0x37,
+  QLEEI__WASM_F64_STORE   = 0x39,
+  QLEEI__WASM_I32_STORE8  = 0x3A,
+  QLEEI__WASM_I32_CONST   = 0x41,
+  QLEEI__WASM_I64_CONST   = 0x42,
+  QLEEI__WASM_F64_CONST   = 0x44,
+  QLEEI__WASM_I32_EQZ     = 0x45,
+  QLEEI__WASM_I32_EQ      = 0x46,
+  QLEEI__WASM_I32_NE      = 0x47,
+  QLEEI__WASM_I32_LT_U    = 0x49,
+  QLEEI__WASM_I32_GE_U    = 0x4F,
+  QLEEI__WASM_I64_EQ      = 0x51,
+  QLEEI__WASM_I64_LT_U    = 0x54,
+  QLEEI__WASM_F64_NE      = 0x62,
+  QLEEI__WASM_I32_ADD     = 0x6A,
+  QLEEI__WASM_I32_SUB     = 0x6B,
+  QLEEI__WASM_I32_MUL     = 0x6C,
+  QLEEI__WASM_I32_AND     = 0x71,
+  QLEEI__WASM_I64_SHR_U   = 0x88,
+  QLEEI__WASM_F64_ADD     = 0xA0,
+  QLEEI__WASM_F64_SUB     = 0xA1,
+  QLEEI__WASM_F64_MUL     = 0xA2,
+  QLEEI__WASM_F64_DIV     = 0xA3,
+};
+
+#define QLEEI__WASM_VOID 0x40
+#define QLEEI__WASM_I32  0x7F
+#define QLEEI__WASM_I64  0x7E
+
+// Functions imported by every module, the generated functions come after them
+enum {
+  QLEEI__WASM_IMPORT_EXECUTE_OP,
+  QLEEI__WASM_IMPORT_CHECK_CALL,
+  QLEEI__WASM_IMPORT_CALL_TOO_DEEP,
+  QLEEI__WASM_IMPORT_CALL,
+  QLEEI__WASM_IMPORT_COUNT,
+};
+
+// The only global of every module counts the procedure calls in progress, they nest on the engine's stack
+#define QLEEI__WASM_GLOBAL_DEPTH 0
+
+// Locals of every generated function, the interpreter is its only parameter. The i64 ones hold an item being moved
+enum {
+  QLEEI__WASM_LOCAL_IT,
+  QLEEI__WASM_LOCAL_STACK,
+  QLEEI__WASM_LOCAL_ITEMS,
+  QLEEI__WASM_LOCAL_LEN,
+  QLEEI__WASM_LOCAL_TMP,
+};
+
+typedef struct {
+  qleei_ui8_t *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+  bool failed; // Sticky, checked once everything was emitted
+} Qleei__Wasm_Buffer;
+
+/**
+ * A `block` or `loop` wrapping the instructions in [open, close) of the code being translated.
+ */
+typedef struct {
+  qleei_uisz_t open;
+  qleei_uisz_t close;
+  bool         loop;
+} Qleei__Wasm_Scope;
+
+typedef struct {
+  Qleei__Wasm_Scope *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei__Wasm_Scopes;
+
+typedef struct {
+  qleei_uisz_t *items;
+  qleei_uisz_t len;
+  qleei_uisz_t cap;
+} Qleei__Wasm_Labels;
+
+struct Qleei_Wasm_Program {
+  Qleei_Interpreter *it;    // `own`, or the interpreter of the document the program was translated from
+  Qleei_Interpreter  own;
+  Qleei__Wasm_Buffer module;
+};
+
+static void qleei__wasm_byte(Qleei__Wasm_Buffer *b, qleei_ui8_t byte) {
+  if (!qleei_alist_append(b, &byte)) b->failed = true;
+}
+
+static void qleei__wasm_bytes(Qleei__Wasm_Buffer *b, const void *data, qleei_uisz_t size) {
+  for (qleei_uisz_t i = 0; i < size; ++i) qleei__wasm_byte(b, ((const qleei_ui8_t *)data)[i]);
+}
+
+static void qleei__wasm_uleb(Qleei__Wasm_Buffer *b, qleei_ui32_t value) {
+  do {
+    qleei_ui8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value != 0) byte |= 0x80;
+    qleei__wasm_byte(b, byte);
+  } while (value != 0);
+}
+
+static void qleei__wasm_sleb(Qleei__Wasm_Buffer *b, qleei_si32_t value) {
+  bool more = true;
+  while (more) {
+    qleei_ui8_t byte = value & 0x7F;
+    value >>= 7;
+    if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40))) more = false;
+    else byte |= 0x80;
+    qleei__wasm_byte(b, byte);
+  }
+}
+
+static void qleei__wasm_name(Qleei__Wasm_Buffer *b, const char *name) {
+  qleei_uisz_t len = qleei_zstr_len(name);
+  qleei__wasm_uleb(b, len);
+  qleei__wasm_bytes(b, name, len);
+}
+
+// Sections and function bodies are prefixed by their size, they are emitted on their own and then appended
+static void qleei__wasm_sized(Qleei__Wasm_Buffer *b, Qleei__Wasm_Buffer *content) {
+  qleei__wasm_uleb(b, content->len);
+  qleei__wasm_bytes(b, content->items, content->len);
+  if (content->failed) b->failed = true;
+  content->len = 0;
+  content->failed = false;
+}
+
+static void qleei__wasm_section(Qleei__Wasm_Buffer *b, qleei_ui8_t id, Qleei__Wasm_Buffer *content) {
+  qleei__wasm_byte(b, id);
+  qleei__wasm_sized(b, content);
+}
+
+static void qleei__wasm_local(Qleei__Wasm_Buffer *b, qleei_ui8_t opcode, qleei_ui32_t local) {
+  qleei__wasm_byte(b, opcode);
+  qleei__wasm_uleb(b, local);
+}
+
+static void qleei__wasm_i32_const(Qleei__Wasm_Buffer *b, qleei_si32_t value) {
+  qleei__wasm_byte(b, QLEEI__WASM_I32_CONST);
+  qleei__wasm_sleb(b, value);
+}
+
+#ifdef QLEEI_NAN_BOXING
+// Only boxed items are compared and built as i64 constants
+static void qleei__wasm_i64_const(Qleei__Wasm_Buffer *b, qleei_ui64_t value) {
+  qleei_si64_t rest = (qleei_si64_t)value;
+  bool more = true;
+  qleei__wasm_byte(b, QLEEI__WASM_I64_CONST);
+  while (more) {
+    qleei_ui8_t byte = rest & 0x7F;
+    rest >>= 7;
+    if ((rest == 0 && !(byte & 0x40)) || (rest == -1 && (byte & 0x40))) more = false;
+    else byte |= 0x80;
+    qleei__wasm_byte(b, byte);
+  }
+}
+#endif // QLEEI_NAN_BOXING
+
+static void qleei__wasm_f64_const(Qleei__Wasm_Buffer *b, double value) {
+  qleei__wasm_byte(b, QLEEI__WASM_F64_CONST);
+  qleei__wasm_bytes(b, &value, sizeof(value));
+}
+
+static void qleei__wasm_memory(Qleei__Wasm_Buffer *b, qleei_ui8_t opcode, qleei_ui32_t align, qleei_ui32_t offset) {
+  qleei__wasm_byte(b, opcode);
+  qleei__wasm_uleb(b, align);
+  qleei__wasm_uleb(b, offset);
+}
+
+static void qleei__wasm_load_stack(Qleei__Wasm_Buffer *b) {
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_STACK);
+  qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD, 2, QLEEI__WASM_OFFSET(Qleei_Stack, items));
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_SET, QLEEI__WASM_LOCAL_ITEMS);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_STACK);
+  qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD, 2, QLEEI__WASM_OFFSET(Qleei_Stack, len));
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_SET, QLEEI__WASM_LOCAL_LEN);
+}
+
+static void qleei__wasm_store_len(Qleei__Wasm_Buffer *b, qleei_si32_t delta) {
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_STACK);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_LEN);
+  qleei__wasm_i32_const(b, delta);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_ADD);
+  qleei__wasm_memory(b, QLEEI__WASM_I32_STORE, 2, QLEEI__WASM_OFFSET(Qleei_Stack, len));
+}
+
+// Address of the `n`th item from the top as loaded by qleei__wasm_load_stack, -1 being the slot past the top
+static void qleei__wasm_item(Qleei__Wasm_Buffer *b, qleei_si32_t n) {
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_LEN);
+  qleei__wasm_i32_const(b, QLEEI__WASM_ITEM_SIZE);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_MUL);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_ITEMS);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_ADD);
+  if (n + 1 != 0) {
+    qleei__wasm_i32_const(b, (n + 1)*QLEEI__WASM_ITEM_SIZE);
+    qleei__wasm_byte(b, QLEEI__WASM_I32_SUB);
+  }
+}
+
+static void qleei__wasm_item_kind_is(Qleei__Wasm_Buffer *b, qleei_si32_t n, Qleei_Value_Kind kind) {
+  qleei__wasm_item(b, n);
+#ifdef QLEEI_NAN_BOXING
+  // Same tests as qleei_value_item_kind
+  qleei__wasm_memory(b, QLEEI__WASM_I64_LOAD, 3, 0);
+  if (kind == QLEEI_VALUE_KIND_NUMBER) {
+    qleei__wasm_i64_const(b, QLEEI_NAN_BOX_TAG_NUMBERS << QLEEI_NAN_BOX_TAG_SHIFT);
+    qleei__wasm_byte(b, QLEEI__WASM_I64_LT_U);
+  } else {
+    qleei__wasm_i64_const(b, QLEEI_NAN_BOX_TAG_SHIFT);
+    qleei__wasm_byte(b, QLEEI__WASM_I64_SHR_U);
+    qleei__wasm_i64_const(b, QLEEI_NAN_BOX_TAG_NUMBERS + kind);
+    qleei__wasm_byte(b, QLEEI__WASM_I64_EQ);
+  }
+#else
+  qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD, 2, QLEEI__WASM_OFFSET(Qleei_Value_Item, kind));
+  qleei__wasm_i32_const(b, kind);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_EQ);
+#endif // QLEEI_NAN_BOXING
+}
+
+static void qleei__wasm_copy_item(Qleei__Wasm_Buffer *b, qleei_si32_t dst, qleei_si32_t src) {
+  for (qleei_uisz_t w = 0; w < QLEEI__WASM_ITEM_WORDS; ++w) {
+    qleei__wasm_item(b, dst);
+    qleei__wasm_item(b, src);
+    qleei__wasm_memory(b, QLEEI__WASM_I64_LOAD, 3, w*8);
+    qleei__wasm_memory(b, QLEEI__WASM_I64_STORE, 3, w*8);
+  }
+}
+
+static void qleei__wasm_save_item(Qleei__Wasm_Buffer *b, qleei_si32_t n) {
+  for (qleei_uisz_t w = 0; w < QLEEI__WASM_ITEM_WORDS; ++w) {
+    qleei__wasm_item(b, n);
+    qleei__wasm_memory(b, QLEEI__WASM_I64_LOAD, 3, w*8);
+    qleei__wasm_local(b, QLEEI__WASM_LOCAL_SET, QLEEI__WASM_LOCAL_TMP + w);
+  }
+}
+
+static void qleei__wasm_restore_item(Qleei__Wasm_Buffer *b, qleei_si32_t n) {
+  for (qleei_uisz_t w = 0; w < QLEEI__WASM_ITEM_WORDS; ++w) {
+    qleei__wasm_item(b, n);
+    qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_TMP + w);
+    qleei__wasm_memory(b, QLEEI__WASM_I64_STORE, 3, w*8);
+  }
+}
+
+// Loads the stack and leaves whether it holds `n` items, and room for one more when `grows`
+static void qleei__wasm_stack_has(Qleei__Wasm_Buffer *b, qleei_si32_t n, bool grows) {
+  qleei__wasm_load_stack(b);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_LEN);
+  qleei__wasm_i32_const(b, n);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_GE_U);
+  if (grows) {
+    qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_LEN);
+    qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_STACK);
+    qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD, 2, QLEEI__WASM_OFFSET(Qleei_Stack, cap));
+    qleei__wasm_byte(b, QLEEI__WASM_I32_LT_U);
+    qleei__wasm_byte(b, QLEEI__WASM_I32_AND);
+  }
+}
+
+static void qleei__wasm_global(Qleei__Wasm_Buffer *b, qleei_ui8_t opcode, qleei_uisz_t index) {
+  qleei__wasm_byte(b, opcode);
+  qleei__wasm_uleb(b, index);
+}
+
+// Leaves the value on top of the engine's stack alone, it can hold the result of the call being counted
+static void qleei__wasm_depth_add(Qleei__Wasm_Buffer *b, qleei_si32_t delta) {
+  qleei__wasm_global(b, QLEEI__WASM_GLOBAL_GET, QLEEI__WASM_GLOBAL_DEPTH);
+  qleei__wasm_i32_const(b, delta);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_ADD);
+  qleei__wasm_global(b, QLEEI__WASM_GLOBAL_SET, QLEEI__WASM_GLOBAL_DEPTH);
+}
+
+static void qleei__wasm_return_unless(Qleei__Wasm_Buffer *b) {
+  qleei__wasm_byte(b, QLEEI__WASM_I32_EQZ);
+  qleei__wasm_byte(b, QLEEI__WASM_IF);
+  qleei__wasm_byte(b, QLEEI__WASM_VOID);
+  qleei__wasm_i32_const(b, 0);
+  qleei__wasm_byte(b, QLEEI__WASM_RETURN);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+}
+
+static void qleei__wasm_execute_op(Qleei__Wasm_Buffer *b, Qleei_Code *code, qleei_uisz_t pc, bool inside_of_proc) {
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+  qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(code));
+  qleei__wasm_i32_const(b, (qleei_si32_t)pc);
+  qleei__wasm_i32_const(b, inside_of_proc);
+  qleei__wasm_byte(b, QLEEI__WASM_CALL);
+  qleei__wasm_uleb(b, QLEEI__WASM_IMPORT_EXECUTE_OP);
+  qleei__wasm_return_unless(b);
+}
+
+// Condition left by the caller picks the inlined path, the instruction goes through the interpreter otherwise
+static void qleei__wasm_fast_path(Qleei__Wasm_Buffer *b) {
+  qleei__wasm_byte(b, QLEEI__WASM_IF);
+  qleei__wasm_byte(b, QLEEI__WASM_VOID);
+}
+
+static void qleei__wasm_slow_path(Qleei__Wasm_Buffer *b, Qleei_Code *code, qleei_uisz_t pc, bool inside_of_proc) {
+  qleei__wasm_byte(b, QLEEI__WASM_ELSE);
+  qleei__wasm_execute_op(b, code, pc, inside_of_proc);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+}
+
+// Pops the loop condition and leaves it as an i32, an empty stack is reported by the interpreter
+static void qleei__wasm_pop_condition(Qleei__Wasm_Buffer *b, Qleei_Code *code, qleei_uisz_t pc, bool inside_of_proc) {
+  qleei__wasm_load_stack(b);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_LEN);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_EQZ);
+  qleei__wasm_byte(b, QLEEI__WASM_IF);
+  qleei__wasm_byte(b, QLEEI__WASM_VOID);
+  qleei__wasm_execute_op(b, code, pc, inside_of_proc);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+  qleei__wasm_store_len(b, -1);
+
+  qleei__wasm_item_kind_is(b, 0, QLEEI_VALUE_KIND_NUMBER);
+  qleei__wasm_byte(b, QLEEI__WASM_IF);
+  qleei__wasm_byte(b, QLEEI__WASM_I32);
+  qleei__wasm_item(b, 0);
+  qleei__wasm_memory(b, QLEEI__WASM_F64_LOAD, 3, QLEEI__WASM_NUMBER_OFFSET);
+  qleei__wasm_f64_const(b, 0.0);
+  qleei__wasm_byte(b, QLEEI__WASM_F64_NE);
+  qleei__wasm_byte(b, QLEEI__WASM_ELSE);
+  qleei__wasm_item_kind_is(b, 0, QLEEI_VALUE_KIND_BOOL);
+  qleei__wasm_byte(b, QLEEI__WASM_IF);
+  qleei__wasm_byte(b, QLEEI__WASM_I32);
+  qleei__wasm_item(b, 0);
+  qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD8_U, 0, QLEEI__WASM_BOOL_OFFSET);
+  qleei__wasm_byte(b, QLEEI__WASM_ELSE);
+  qleei__wasm_item(b, 0);
+  qleei__wasm_memory(b, QLEEI__WASM_I32_LOAD, 2, QLEEI__WASM_POINTER_OFFSET);
+  qleei__wasm_i32_const(b, 0);
+  qleei__wasm_byte(b, QLEEI__WASM_I32_NE);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+}
+
+static void qleei__wasm_branch(Qleei__Wasm_Buffer *b, qleei_ui8_t opcode, Qleei__Wasm_Scopes *scopes, Qleei__Wasm_Labels *labels, qleei_uisz_t target, bool backward) {
+  qleei_uisz_t depth = 0;
+  for (qleei_uisz_t i = labels->len; i > 0; --i, ++depth) {
+    Qleei__Wasm_Scope *scope = &scopes->items[labels->items[i - 1]];
+    if (backward ? (scope->loop && scope->open == target) : (!scope->loop && scope->close == target)) break;
+  }
+  if (depth == labels->len) b->failed = true;
+  qleei__wasm_byte(b, opcode);
+  qleei__wasm_uleb(b, depth);
+}
+
+// `while C begin B end` compiles to either `C JUMP_UNLESS(exit) B C JUMP_IF(B)` or `C JUMP_UNLESS(exit) B JUMP(C)`,
+// the loop wraps what the backward jump goes back to and a block around it is what the forward jump leaves
+static bool qleei__wasm_collect_scopes(Qleei_Code *code, Qleei__Wasm_Scopes *scopes) {
+  for (qleei_uisz_t i = 0; i < code->len; ++i) {
+    Qleei_Op *op = &code->items[i];
+    if (op->kind != QLEEI_OP_JUMP_UNLESS) continue;
+    qleei_uisz_t exit = op->arg;
+    if (exit <= i + 1 || exit > code->len) return false;
+    Qleei_Op *back = &code->items[exit - 1];
+    if ((back->kind != QLEEI_OP_JUMP && back->kind != QLEEI_OP_JUMP_IF) || back->arg >= exit - 1) return false;
+
+    Qleei__Wasm_Scope block = { .open = back->arg < i ? back->arg : i, .close = exit, .loop = false };
+    Qleei__Wasm_Scope loop  = { .open = back->arg, .close = exit, .loop = true };
+    if (!qleei_alist_append(scopes, &block)) return false;
+    if (!qleei_alist_append(scopes, &loop)) return false;
+  }
+
+  // Outer scopes open first, a block opening with a loop surrounds it
+  for (qleei_uisz_t i = 1; i < scopes->len; ++i) {
+    for (qleei_uisz_t j = i; j > 0; --j) {
+      Qleei__Wasm_Scope *a = &scopes->items[j - 1], *b = &scopes->items[j];
+      bool ordered = a->open < b->open || (a->open == b->open && (a->close > b->close || (a->close == b->close && !a->loop)));
+      if (ordered) break;
+      qleei_alist_swap(scopes, j - 1, j);
+    }
+  }
+  return true;
+}
+
+// Marks the procedures that can call themselves back through any chain of calls. Only calls to the others nest on
+// the engine's stack, so that nesting is bounded by the number of procedures
+static bool qleei__wasm_find_recursion(Qleei_Interpreter *it, bool *recursive) {
+  qleei_uisz_t count = it->procs.len;
+  if (count == 0) return true;
+  bool *reached = qleei_mem_alloc(count*sizeof(bool));
+  qleei_uisz_t *worklist = qleei_mem_alloc(count*sizeof(qleei_uisz_t));
+  if (reached == NULL || worklist == NULL) {
+    if (reached != NULL)  qleei_mem_free(reached);
+    if (worklist != NULL) qleei_mem_free(worklist);
+    return false;
+  }
+
+  for (qleei_uisz_t p = 0; p < count; ++p) {
+    for (qleei_uisz_t q = 0; q < count; ++q) reached[q] = false;
+    qleei_uisz_t worklist_len = 0;
+    qleei_uisz_t caller = p;
+    recursive[p] = false;
+    while (!recursive[p]) {
+      Qleei_Code *body = &it->procs.items[caller].body;
+      for (qleei_uisz_t i = 0; i < body->len; ++i) {
+        if (body->items[i].kind != QLEEI_OP_CALL) continue;
+        Qleei_Proc *callee = qleei__verify_callee(it, body, i);
+        if (callee == NULL) continue;
+        qleei_uisz_t index = callee - it->procs.items;
+        if (reached[index]) continue;
+        reached[index] = true;
+        worklist[worklist_len++] = index;
+      }
+      recursive[p] = reached[p];
+      if (worklist_len == 0) break;
+      caller = worklist[--worklist_len];
+    }
+  }
+
+  qleei_mem_free(reached);
+  qleei_mem_free(worklist);
+  return true;
+}
+
+static bool qleei__wasm_function(Qleei__Wasm_Buffer *b, Qleei_Interpreter *it, Qleei_Code *code, bool inside_of_proc, const bool *recursive) {
+  Qleei__Wasm_Scopes scopes = {0};
+  Qleei__Wasm_Labels labels = {0};
+  bool result = qleei__wasm_collect_scopes(code, &scopes);
+
+  qleei__wasm_uleb(b, 2);
+  qleei__wasm_uleb(b, QLEEI__WASM_LOCAL_TMP - 1);
+  qleei__wasm_byte(b, QLEEI__WASM_I32);
+  qleei__wasm_uleb(b, QLEEI__WASM_ITEM_WORDS);
+  qleei__wasm_byte(b, QLEEI__WASM_I64);
+
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+  qleei__wasm_i32_const(b, QLEEI__WASM_OFFSET(Qleei_Interpreter, stack));
+  qleei__wasm_byte(b, QLEEI__WASM_I32_ADD);
+  qleei__wasm_local(b, QLEEI__WASM_LOCAL_SET, QLEEI__WASM_LOCAL_STACK);
+
+  qleei_uisz_t next_scope = 0;
+  for (qleei_uisz_t i = 0; result && i < code->len; ++i) {
+    while (labels.len > 0 && scopes.items[labels.items[labels.len - 1]].close == i) {
+      qleei__wasm_byte(b, QLEEI__WASM_END);
+      labels.len--;
+    }
+    while (next_scope < scopes.len && scopes.items[next_scope].open == i) {
+      qleei__wasm_byte(b, scopes.items[next_scope].loop ? QLEEI__WASM_LOOP : QLEEI__WASM_BLOCK);
+      qleei__wasm_byte(b, QLEEI__WASM_VOID);
+      if (!qleei_alist_append(&labels, &next_scope)) result = false;
+      next_scope++;
+    }
+
+    Qleei_Op *op = &code->items[i];
+    switch (op->kind) {
+    case QLEEI_OP_PUSH_NUMBER:
+    case QLEEI_OP_PUSH_BOOL:
+      qleei__wasm_stack_has(b, 0, true);
+      qleei__wasm_fast_path(b);
+#ifdef QLEEI_NAN_BOXING
+      qleei__wasm_item(b, -1);
+      if (op->kind == QLEEI_OP_PUSH_NUMBER) {
+        qleei__wasm_f64_const(b, op->number);
+        qleei__wasm_memory(b, QLEEI__WASM_F64_STORE, 3, QLEEI__WASM_NUMBER_OFFSET);
+      } else {
+        qleei__wasm_i64_const(b, qleei_value_item_from_bool(op->number == 1.0).bits);
+        qleei__wasm_memory(b, QLEEI__WASM_I64_STORE, 3, 0);
+      }
+#else
+      qleei__wasm_item(b, -1);
+      qleei__wasm_i32_const(b, op->kind == QLEEI_OP_PUSH_NUMBER ? QLEEI_VALUE_KIND_NUMBER : QLEEI_VALUE_KIND_BOOL);
+      qleei__wasm_memory(b, QLEEI__WASM_I32_STORE, 2, QLEEI__WASM_OFFSET(Qleei_Value_Item, kind));
+      qleei__wasm_item(b, -1);
+      if (op->kind == QLEEI_OP_PUSH_NUMBER) {
+        qleei__wasm_f64_const(b, op->number);
+        qleei__wasm_memory(b, QLEEI__WASM_F64_STORE, 3, QLEEI__WASM_NUMBER_OFFSET);
+      } else {
+        qleei__wasm_i32_const(b, op->number == 1.0);
+        qleei__wasm_memory(b, QLEEI__WASM_I32_STORE8, 0, QLEEI__WASM_BOOL_OFFSET);
+      }
+#endif // QLEEI_NAN_BOXING
+      qleei__wasm_store_len(b, 1);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+      break;
+
+    case QLEEI_OP_DUP:
+    case QLEEI_OP_OVER:
+      qleei__wasm_stack_has(b, op->kind == QLEEI_OP_DUP ? 1 : 2, true);
+      qleei__wasm_fast_path(b);
+      qleei__wasm_copy_item(b, -1, op->kind == QLEEI_OP_DUP ? 0 : 1);
+      qleei__wasm_store_len(b, 1);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+      break;
+
+    case QLEEI_OP_DROP:
+      qleei__wasm_stack_has(b, 1, false);
+      qleei__wasm_fast_path(b);
+      qleei__wasm_store_len(b, -1);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+      break;
+
+    case QLEEI_OP_ROT2:
+    case QLEEI_OP_SWAP3:
+      qleei__wasm_stack_has(b, op->kind == QLEEI_OP_ROT2 ? 2 : 3, false);
+      qleei__wasm_fast_path(b);
+      qleei__wasm_save_item(b, 0);
+      qleei__wasm_copy_item(b, 0, op->kind == QLEEI_OP_ROT2 ? 1 : 2);
+      qleei__wasm_restore_item(b, op->kind == QLEEI_OP_ROT2 ? 1 : 2);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+      break;
+
+    case QLEEI_OP_ROT3:
+      qleei__wasm_stack_has(b, 3, false);
+      qleei__wasm_fast_path(b);
+      qleei__wasm_save_item(b, 0);
+      qleei__wasm_copy_item(b, 0, 1);
+      qleei__wasm_copy_item(b, 1, 2);
+      qleei__wasm_restore_item(b, 2);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+      break;
+
+    case QLEEI_OP_ADD:
+    case QLEEI_OP_SUB:
+    case QLEEI_OP_MUL:
+    case QLEEI_OP_DIV: {
+      qleei_ui8_t opcode = op->kind == QLEEI_OP_ADD ? QLEEI__WASM_F64_ADD
+                         : op->kind == QLEEI_OP_SUB ? QLEEI__WASM_F64_SUB
+                         : op->kind == QLEEI_OP_MUL ? QLEEI__WASM_F64_MUL
+                         :                            QLEEI__WASM_F64_DIV;
+      qleei__wasm_stack_has(b, 2, false);
+      qleei__wasm_byte(b, QLEEI__WASM_IF);
+      qleei__wasm_byte(b, QLEEI__WASM_I32);
+      qleei__wasm_item_kind_is(b, 0, QLEEI_VALUE_KIND_NUMBER);
+      qleei__wasm_item_kind_is(b, 1, QLEEI_VALUE_KIND_NUMBER);
+      qleei__wasm_byte(b, QLEEI__WASM_I32_AND);
+      qleei__wasm_byte(b, QLEEI__WASM_ELSE);
+      qleei__wasm_i32_const(b, 0);
+      qleei__wasm_byte(b, QLEEI__WASM_END);
+      qleei__wasm_fast_path(b);
+      qleei__wasm_item(b, 1);
+      qleei__wasm_item(b, 0);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_LOAD, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_item(b, 1);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_LOAD, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_byte(b, opcode);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_STORE, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_store_len(b, -1);
+      qleei__wasm_slow_path(b, code, i, inside_of_proc);
+    } break;
+
+    case QLEEI_OP_ADD_NUMBERS:
+    case QLEEI_OP_SUB_NUMBERS:
+    case QLEEI_OP_MUL_NUMBERS:
+    case QLEEI_OP_DIV_NUMBERS: {
+      // Proven by the verifier, there is nothing left to check
+      qleei_ui8_t opcode = op->kind == QLEEI_OP_ADD_NUMBERS ? QLEEI__WASM_F64_ADD
+                         : op->kind == QLEEI_OP_SUB_NUMBERS ? QLEEI__WASM_F64_SUB
+                         : op->kind == QLEEI_OP_MUL_NUMBERS ? QLEEI__WASM_F64_MUL
+                         :                                    QLEEI__WASM_F64_DIV;
+      qleei__wasm_load_stack(b);
+      qleei__wasm_item(b, 1);
+      qleei__wasm_item(b, 0);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_LOAD, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_item(b, 1);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_LOAD, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_byte(b, opcode);
+      qleei__wasm_memory(b, QLEEI__WASM_F64_STORE, 3, QLEEI__WASM_NUMBER_OFFSET);
+      qleei__wasm_store_len(b, -1);
+    } break;
+
+    case QLEEI_OP_JUMP:
+      qleei__wasm_branch(b, QLEEI__WASM_BR, &scopes, &labels, op->arg, true);
+      break;
+
+    case QLEEI_OP_JUMP_UNLESS:
+      qleei__wasm_pop_condition(b, code, i, inside_of_proc);
+      qleei__wasm_byte(b, QLEEI__WASM_I32_EQZ);
+      qleei__wasm_branch(b, QLEEI__WASM_BR_IF, &scopes, &labels, op->arg, false);
+      break;
+
+    case QLEEI_OP_JUMP_IF:
+      qleei__wasm_pop_condition(b, code, i, inside_of_proc);
+      qleei__wasm_branch(b, QLEEI__WASM_BR_IF, &scopes, &labels, op->arg, true);
+      break;
+
+    case QLEEI_OP_CALL: {
+      Qleei_Proc *proc = qleei__verify_callee(it, code, i);
+      if (proc == NULL) {
+        qleei__wasm_execute_op(b, code, i, inside_of_proc);
+        break;
+      }
+      qleei_uisz_t index = proc - it->procs.items;
+      if (op->arg != index + 1) {
+        // Same check as qleei_proc_check_inputs, which is only called to report the error
+        qleei__wasm_stack_has(b, proc->inputs.len, false);
+        if (proc->inputs.len > 0) {
+          qleei__wasm_byte(b, QLEEI__WASM_IF);
+          qleei__wasm_byte(b, QLEEI__WASM_I32);
+          qleei__wasm_i32_const(b, 1);
+          for (qleei_uisz_t k = 0; k < proc->inputs.len; ++k) {
+            qleei__wasm_item_kind_is(b, (qleei_si32_t)k, proc->inputs.items[k]);
+            qleei__wasm_byte(b, QLEEI__WASM_I32_AND);
+          }
+          qleei__wasm_byte(b, QLEEI__WASM_ELSE);
+          qleei__wasm_i32_const(b, 0);
+          qleei__wasm_byte(b, QLEEI__WASM_END);
+        }
+        qleei__wasm_byte(b, QLEEI__WASM_I32_EQZ);
+        qleei__wasm_byte(b, QLEEI__WASM_IF);
+        qleei__wasm_byte(b, QLEEI__WASM_VOID);
+        qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+        qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(code));
+        qleei__wasm_i32_const(b, (qleei_si32_t)i);
+        qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(proc));
+        qleei__wasm_byte(b, QLEEI__WASM_CALL);
+        qleei__wasm_uleb(b, QLEEI__WASM_IMPORT_CHECK_CALL);
+        qleei__wasm_return_unless(b);
+        qleei__wasm_byte(b, QLEEI__WASM_END);
+      }
+      // Fails past the same depth as the interpreter instead of exhausting the engine's stack
+      qleei__wasm_global(b, QLEEI__WASM_GLOBAL_GET, QLEEI__WASM_GLOBAL_DEPTH);
+      qleei__wasm_i32_const(b, QLEEI_MAX_CALL_DEPTH);
+      qleei__wasm_byte(b, QLEEI__WASM_I32_GE_U);
+      qleei__wasm_byte(b, QLEEI__WASM_IF);
+      qleei__wasm_byte(b, QLEEI__WASM_VOID);
+      qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+      qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(code));
+      qleei__wasm_i32_const(b, (qleei_si32_t)i);
+      qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(proc));
+      qleei__wasm_byte(b, QLEEI__WASM_CALL);
+      qleei__wasm_uleb(b, QLEEI__WASM_IMPORT_CALL_TOO_DEEP);
+      qleei__wasm_byte(b, QLEEI__WASM_RETURN);
+      qleei__wasm_byte(b, QLEEI__WASM_END);
+      qleei__wasm_depth_add(b, 1);
+      qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+      if (recursive[index]) {
+        // The interpreter keeps its frames on the heap, a recursion nesting on the engine's stack would overflow it
+        // long before QLEEI_MAX_CALL_DEPTH
+        qleei__wasm_i32_const(b, QLEEI__WASM_ADDRESS(code));
+        qleei__wasm_i32_const(b, (qleei_si32_t)i);
+        qleei__wasm_global(b, QLEEI__WASM_GLOBAL_GET, QLEEI__WASM_GLOBAL_DEPTH);
+        qleei__wasm_byte(b, QLEEI__WASM_CALL);
+        qleei__wasm_uleb(b, QLEEI__WASM_IMPORT_CALL);
+      } else {
+        qleei__wasm_byte(b, QLEEI__WASM_CALL);
+        qleei__wasm_uleb(b, QLEEI__WASM_IMPORT_COUNT + index);
+      }
+      qleei__wasm_depth_add(b, -1);
+      qleei__wasm_return_unless(b);
+    } break;
+
+    case QLEEI_OP_HALT:
+      qleei__wasm_local(b, QLEEI__WASM_LOCAL_GET, QLEEI__WASM_LOCAL_IT);
+      qleei__wasm_i32_const(b, 1);
+      qleei__wasm_memory(b, QLEEI__WASM_I32_STORE8, 0, QLEEI__WASM_OFFSET(Qleei_Interpreter, done));
+      qleei__wasm_i32_const(b, 1);
+      qleei__wasm_byte(b, QLEEI__WASM_RETURN);
+      break;
+
+    case QLEEI_OP_RETURN:
+      qleei__wasm_i32_const(b, 1);
+      qleei__wasm_byte(b, QLEEI__WASM_RETURN);
+      break;
+
+    default:
+      qleei__wasm_execute_op(b, code, i, inside_of_proc);
+      break;
+    }
+  }
+  if (labels.len != 0) result = false;
+  qleei__wasm_byte(b, QLEEI__WASM_UNREACHABLE);
+  qleei__wasm_byte(b, QLEEI__WASM_END);
+
+  qleei_alist_free(&scopes);
+  qleei_alist_free(&labels);
+  return result;
+}
+
+static bool qleei__wasm_module(Qleei__Wasm_Buffer *b, Qleei_Interpreter *it) {
+  static const qleei_ui8_t header[] = { 0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00 };
+  qleei__wasm_bytes(b, header, sizeof(header));
+
+  Qleei__Wasm_Buffer section = {0};
+  Qleei__Wasm_Buffer body = {0};
+  bool result = true;
+  qleei_uisz_t function_count = it->procs.len + 1;
+
+  // Type 0 is every generated function, type 1 every import
+  static const qleei_ui8_t types[] = {
+    2,
+    0x60, 1, QLEEI__WASM_I32, 1, QLEEI__WASM_I32,
+    0x60, 4, QLEEI__WASM_I32, QLEEI__WASM_I32, QLEEI__WASM_I32, QLEEI__WASM_I32, 1, QLEEI__WASM_I32,
+  };
+  qleei__wasm_bytes(&section, types, sizeof(types));
+  qleei__wasm_section(b, 1, &section);
+
+  qleei__wasm_uleb(&section, 1 + QLEEI__WASM_IMPORT_COUNT);
+  qleei__wasm_name(&section, "env");
+  qleei__wasm_name(&section, "memory");
+  qleei__wasm_byte(&section, 0x02);
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, 0);
+  qleei__wasm_name(&section, "env");
+  qleei__wasm_name(&section, "qleei_wasm_program_execute_op");
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, 1);
+  qleei__wasm_name(&section, "env");
+  qleei__wasm_name(&section, "qleei_wasm_program_check_call");
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, 1);
+  qleei__wasm_name(&section, "env");
+  qleei__wasm_name(&section, "qleei_wasm_program_call_too_deep");
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, 1);
+  qleei__wasm_name(&section, "env");
+  qleei__wasm_name(&section, "qleei_wasm_program_call");
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, 1);
+  qleei__wasm_section(b, 2, &section);
+
+  qleei__wasm_uleb(&section, function_count);
+  for (qleei_uisz_t i = 0; i < function_count; ++i) qleei__wasm_uleb(&section, 0);
+  qleei__wasm_section(b, 3, &section);
+
+  // QLEEI__WASM_GLOBAL_DEPTH, a mutable i32 starting at 0
+  static const qleei_ui8_t globals[] = { 1, QLEEI__WASM_I32, 0x01, QLEEI__WASM_I32_CONST, 0x00, QLEEI__WASM_END };
+  qleei__wasm_bytes(&section, globals, sizeof(globals));
+  qleei__wasm_section(b, 6, &section);
+
+  qleei__wasm_uleb(&section, 1);
+  qleei__wasm_name(&section, "main");
+  qleei__wasm_byte(&section, 0x00);
+  qleei__wasm_uleb(&section, QLEEI__WASM_IMPORT_COUNT + it->procs.len);
+  qleei__wasm_section(b, 7, &section);
+
+  bool *recursive = qleei_mem_alloc(function_count*sizeof(bool));
+  if (recursive == NULL || !qleei__wasm_find_recursion(it, recursive)) result = false;
+
+  qleei__wasm_uleb(&section, function_count);
+  for (qleei_uisz_t p = 0; result && p < it->procs.len; ++p) {
+    result = qleei__wasm_function(&body, it, &it->procs.items[p].body, true, recursive);
+    qleei__wasm_sized(&section, &body);
+  }
+  if (result) result = qleei__wasm_function(&body, it, &it->code, false, recursive);
+  qleei__wasm_sized(&section, &body);
+  qleei__wasm_section(b, 10, &section);
+
+  if (section.failed || body.failed || b->failed) result = false;
+  if (recursive != NULL) qleei_mem_free(recursive);
+  qleei_alist_free(&section);
+  qleei_alist_free(&body);
+  return result;
+}
+
+// The fallback runs one instruction, superinstructions would run the rest of their sequence along with it
+static void qleei__wasm_unfuse_code(Qleei_Code *code) {
+  qleei_alist_foreach(Qleei_Op, op, code) op->kind = qleei__fused_base_kind(op->kind);
+}
+
+// Translates the program compiled into `program->it`, freeing the program if it failed to compile
+static Qleei_Wasm_Program *qleei__wasm_program_translate(Qleei_Wasm_Program *program, bool compiled) {
+  Qleei_Interpreter *it = program->it;
+  if (compiled) {
+    qleei__wasm_unfuse_code(&it->code);
+    qleei_alist_foreach(Qleei_Proc, proc, &it->procs) qleei__wasm_unfuse_code(&proc->body);
+    compiled = qleei__wasm_module(&program->module, it);
+    if (!compiled) qleei_printfn("[ERROR] Could not translate the program to a WebAssembly module");
+  }
+  if (!compiled) {
+    qleei_wasm_program_free(program);
+    return NULL;
+  }
+  return program;
+}
+
+Qleei_Wasm_Program *qleei_wasm_program_new(const char *input_path, const char *buffer, qleei_uisz_t buf_size) {
+  Qleei_Wasm_Program *program = qleei_mem_alloc(sizeof(Qleei_Wasm_Program));
+  if (program == NULL) return NULL;
+  *program = (Qleei_Wasm_Program){0};
+  program->it = &program->own;
+  qleei_interpreter_lexer_init(program->it, input_path, buffer, buf_size);
+  return qleei__wasm_program_translate(program, qleei_compile(program->it));
+}
+
+Qleei_Wasm_Program *qleei_wasm_program_from_document(Qleei_Document *doc) {
+  Qleei_Wasm_Program *program = qleei_mem_alloc(sizeof(Qleei_Wasm_Program));
+  if (program == NULL) return NULL;
+  *program = (Qleei_Wasm_Program){0};
+  program->it = qleei_document_interpreter(doc);
+  return qleei__wasm_program_translate(program, qleei_document_compile(doc));
+}
+
+const qleei_ui8_t *qleei_wasm_program_module(Qleei_Wasm_Program *program) {
+  return program->module.items;
+}
+
+qleei_uisz_t qleei_wasm_program_module_size(Qleei_Wasm_Program *program) {
+  return program->module.len;
+}
+
+Qleei_Interpreter *qleei_wasm_program_interpreter(Qleei_Wasm_Program *program) {
+  return program->it;
+}
+
+void qleei_wasm_program_free(Qleei_Wasm_Program *program) {
+  if (program == NULL) return;
+  if (program->it == &program->own) qleei_interpreter_free(&program->own);
+  qleei_alist_free(&program->module);
+  qleei_mem_free(program);
+}
+
+bool qleei_wasm_program_execute_op(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, bool inside_of_proc) {
+  return qleei_execute_op(it, code, &pc, inside_of_proc);
+}
+
+bool qleei_wasm_program_check_call(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, Qleei_Proc *proc) {
+  return qleei_proc_check_inputs(proc, &it->stack, code->tokens.items[pc]);
+}
+
+bool qleei_wasm_program_call(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, qleei_uisz_t depth) {
+  // The calls nesting in the module have no frames, stand in for them so the limit is hit at the same call
+  qleei_uisz_t frames_len = it->frames.len;
+  Qleei_Frame frame = {0};
+  bool result = true;
+  for (qleei_uisz_t d = 0; result && d < depth; ++d) result = qleei_alist_append(&it->frames, &frame);
+  // Only calls to procedures come through here, they don't look at `inside_of_proc`
+  if (result) result = qleei_execute_op(it, code, &pc, true);
+  it->frames.len = frames_len;
+  return result;
+}
+
+bool qleei_wasm_program_call_too_deep(Qleei_Interpreter *it, Qleei_Code *code, qleei_uisz_t pc, Qleei_Proc *proc) {
+  (void)it;
+  (void)proc;
+  qleei_loc_printfn(code->tokens.items[pc].loc, "[ERROR] Too many nested procedure calls, the limit is %d", QLEEI_MAX_CALL_DEPTH);
+  return false;
+}
+
+#undef QLEEI__WASM_OFFSET
+#undef QLEEI__WASM_ADDRESS
+#undef QLEEI__WASM_ITEM_SIZE
+#undef QLEEI__WASM_ITEM_WORDS
+#undef QLEEI__WASM_VOID
+#undef QLEEI__WASM_I32
+#undef QLEEI__WASM_I64
 
 #endif // PLATFORM_BROWSER
 
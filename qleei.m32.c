@@ -5,33 +5,43 @@
 #define PLATFORM_DESKTOP
 #include "qleei.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 /**
  * Print the program usage message to the specified stream.
  *
- * Writes "Usage: <program> <input-file>\n" to the provided FILE stream,
- * substituting the given program name.
+ * Writes "Usage: <program> <input-file|-> [--fusion-report] [--emit-c <output-file>]\n" to the provided FILE stream,
+ * substituting the given program name, followed by how a program read from stdin runs. Builds with QLEEI_AOT run the
+ * translated program and take no arguments.
  *
  * @param f Output stream to receive the usage message.
  * @param program Program name to display in the usage message.
  */
 void usage(FILE *f, const char *program) {
-  fprintf(f, "Usage: %s <input-file>\n", program);
+#ifdef QLEEI_AOT
+  fprintf(f, "Usage: %s\n", program);
+#else
+  fprintf(f, "Usage: %s <input-file|-> [--fusion-report] [--emit-c <output-file>]\n", program);
+  fprintf(f, "  -  Run the program from stdin as it is read, a call to a procedure defined further down waits for its definition\n");
+#endif // QLEEI_AOT
 }
 
-bool word_handler_sub(Qleei_Word_Handler_Opt opt) {
-  if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 2)) return false;
+// The interpreter checks for the two numbers declared here before calling `word_handler_sub`
+static const Qleei_Word_Signature word_signature_sub = {
+  .inputs_len = 2,  .inputs  = { QLEEI_VALUE_KIND_NUMBER, QLEEI_VALUE_KIND_NUMBER },
+  .outputs_len = 1, .outputs = { QLEEI_VALUE_KIND_NUMBER },
+};
 
-  Qleei_Value_Item item_a, item_b;
-  qleei_stack_pop(opt.stack, &item_a);
-  qleei_stack_pop(opt.stack, &item_b);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item_a.kind, QLEEI_VALUE_KIND_NUMBER)) return false;
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item_b.kind, QLEEI_VALUE_KIND_NUMBER)) return false;
-  item_a.as_number.value = item_b.as_number.value - item_a.as_number.value;
-  return qleei_stack_push(opt.stack, item_a);
+bool word_handler_sub(const Qleei_Word_Context *ctx, Qleei_Value_Item *slots) {
+  (void)ctx;
+  slots[0] = qleei_value_item_from_number(qleei_value_item_number(slots[0]) - qleei_value_item_number(slots[1]));
+  return true;
 }
 
 bool word_handler_at_hello_world(Qleei_Word_Handler_Opt opt) {
-  Qleei_Value_Item item = { .as_pointer = { .kind = QLEEI_VALUE_KIND_POINTER, .value = (char*)opt.user_data } };
+  Qleei_Value_Item item = qleei_value_item_from_pointer(opt.user_data);
   return qleei_stack_push(opt.stack, item);
 }
 
@@ -39,19 +49,114 @@ bool word_handler_at_zstr_pound_ascci_upper(Qleei_Word_Handler_Opt opt) {
   if (!qleei_stack_operation_requires_n_items(opt.token.loc, opt.stack, opt.token.string, 1)) return false;
   Qleei_Value_Item item_ptr;
   qleei_stack_pop(opt.stack, &item_ptr);
-  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, item_ptr.kind, QLEEI_VALUE_KIND_POINTER)) return false;
-  for (char *ptr = item_ptr.as_pointer.value; *ptr != 0; ++ptr) {
+  if (!qleei_action_expects_value_kind(opt.token.loc, opt.token.string, qleei_value_item_kind(item_ptr), QLEEI_VALUE_KIND_POINTER)) return false;
+  for (char *ptr = qleei_value_item_pointer(item_ptr); *ptr != 0; ++ptr) {
     char c = *ptr;
     if ('a' <= c && c <= 'z') *ptr = c - 32;
   }
   return true;
 }
 
+/**
+ * Register the custom words this program exposes to Qleei code.
+ *
+ * @param it Interpreter to register the words on.
+ * @param hello_world String pushed by "@hello_world".
+ */
+void register_words(Qleei_Interpreter *it, char *hello_world) {
+  qleei_interpreter_register_fast_word(it, "sub", word_handler_sub, &word_signature_sub, NULL);
+  qleei_interpreter_register_word_with_data(it, "@hello_world", word_handler_at_hello_world, hello_world);
+  qleei_interpreter_register_word(it, "@zstr#ascii_upper", word_handler_at_zstr_pound_ascci_upper);
+}
+
+#ifdef QLEEI_AOT
+
+// Defined by the C file generated with --emit-c
+bool qleei_aot_main(Qleei_Interpreter *it);
+
+int main(int argc, char **argv) {
+  const char *program = nob_shift(argv, argc);
+  if (argc > 0) {
+    usage(stderr, program);
+    return 1;
+  }
+
+  int result = 0;
+
+  Qleei_Interpreter it = {0};
+  char *hello_world = qleei_zstr_dup("Hello, World!");
+  register_words(&it, hello_world);
+  if (!qleei_aot_main(&it)) result = 1;
+
+  qleei_mem_free(hello_world);
+  qleei_interpreter_free(&it);
+
+  return result;
+}
+
+#else
+
+// Source text of the input file, either mapped read-only or read into `sb` when it cannot be mapped
+typedef struct {
+  const char *data;
+  size_t len;
+  void *mapping;
+  size_t mapping_len;
+  Nob_String_Builder sb;
+} Source_File;
+
+/**
+ * Load the input file for the lexer. Regular files are mapped read-only and advised for sequential access so the
+ * program starts executing without copying the file first, anything else (pipes, devices) is read the usual way.
+ *
+ * @param path Path of the input file.
+ * @param src Receives the source text, release it with source_file_close.
+ * @returns false if the file could not be opened or read.
+ */
+bool source_file_open(const char *path, Source_File *src) {
+  *src = (Source_File){0};
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    nob_log(NOB_ERROR, "Could not open file %s: %s", path, strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      close(fd);
+      madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+      src->mapping = mapping;
+      src->mapping_len = (size_t)st.st_size;
+      src->data = mapping;
+      src->len = src->mapping_len;
+      if (src->len > 0 && src->data[src->len - 1] == 0) src->len--;
+      return true;
+    }
+  }
+  close(fd);
+
+  if (!nob_read_entire_file(path, &src->sb)) return false;
+  if (src->sb.count > 0 && src->sb.items[src->sb.count - 1] == 0) src->sb.count--;
+  src->data = src->sb.items;
+  src->len = src->sb.count;
+  return true;
+}
+
+// Unmap or free the source text, the interpreter that lexed it must be freed first
+void source_file_close(Source_File *src) {
+  if (src->mapping != NULL) munmap(src->mapping, src->mapping_len);
+  nob_sb_free(src->sb);
+  *src = (Source_File){0};
+}
+
 /**
  * Program entry point that reads a source file and invokes the QLEEI interpreter on its contents.
  *
  * Handles "-h" and "--help" by printing usage and exiting successfully. If no input path is provided,
- * prints usage to stderr and exits with an error.
+ * prints usage to stderr and exits with an error. An input path of "-" executes the program from stdin while it is
+ * still being read. "--fusion-report" after the input path prints which superinstructions were fused once the
+ * program has run, "--emit-c <output-file>" translates the program to C instead of running it.
  *
  * @returns 0 on successful interpretation; 1 on error (missing input, file read failure, or interpreter failure).
  */
@@ -69,24 +174,71 @@ int main(int argc, char **argv) {
     return 0;
   }
 
-  Nob_String_Builder sb = {0};
+  bool fusion_report = false;
+  const char *emit_c_path = NULL;
+  while (argc > 0) {
+    const char *flag = nob_shift(argv, argc);
+    if (strcmp(flag, "--fusion-report") == 0) {
+      fusion_report = true;
+    } else if (strcmp(flag, "--emit-c") == 0) {
+      if (argc == 0) {
+        nob_log(NOB_ERROR, "No output file was provided for --emit-c");
+        usage(stderr, program);
+        return 1;
+      }
+      emit_c_path = nob_shift(argv, argc);
+    } else {
+      nob_log(NOB_ERROR, "Unknown flag %s", flag);
+      usage(stderr, program);
+      return 1;
+    }
+  }
+
+  if (strcmp(input_path, "-") == 0) {
+    if (emit_c_path != NULL) {
+      nob_log(NOB_ERROR, "--emit-c needs the whole program, it cannot translate stdin");
+      return 1;
+    }
+    int result = 0;
+    Qleei_Interpreter it = {0};
+    char *hello_world = qleei_zstr_dup("Hello, World!");
+    register_words(&it, hello_world);
+    if (!qleei_interpreter_exec_fd(&it, "<stdin>", STDIN_FILENO)) result = 1;
+    if (fusion_report) qleei_print_fusion_report(&it);
 
-  if (!nob_read_entire_file(input_path, &sb)) return 1;
+    qleei_mem_free(hello_world);
+    qleei_interpreter_free(&it);
+    return result;
+  }
 
-  if (sb.count > 0 && sb.items[sb.count - 1] == 0) sb.count--;
+  Source_File src;
+  if (!source_file_open(input_path, &src)) return 1;
 
   int result = 0;
 
   Qleei_Interpreter it = {0};
-  qleei_interpreter_lexer_init(&it, input_path, sb.items, sb.count);
-  qleei_interpreter_register_word(&it, "sub", word_handler_sub);
+  qleei_interpreter_lexer_init(&it, input_path, src.data, src.len);
   char *hello_world = qleei_zstr_dup("Hello, World!");
-  qleei_interpreter_register_word_with_data(&it, "@hello_world", word_handler_at_hello_world, hello_world);
-  qleei_interpreter_register_word(&it, "@zstr#ascii_upper", word_handler_at_zstr_pound_ascci_upper);
-  if (!qleei_interpreter_exec(&it)) result = 1;
+  register_words(&it, hello_world);
+  if (emit_c_path != NULL) {
+    FILE *out = fopen(emit_c_path, "w");
+    if (out == NULL) {
+      nob_log(NOB_ERROR, "Could not open %s: %s", emit_c_path, strerror(errno));
+      result = 1;
+    } else {
+      if (!qleei_translate_to_c(&it, out)) result = 1;
+      fclose(out);
+    }
+  } else {
+    if (!qleei_interpreter_exec(&it)) result = 1;
+  }
+  if (fusion_report) qleei_print_fusion_report(&it);
 
   qleei_mem_free(hello_world);
   qleei_interpreter_free(&it);
+  source_file_close(&src);
 
   return result;
 }
+
+#endif // QLEEI_AOT
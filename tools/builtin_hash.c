@@ -0,0 +1,124 @@
+// Works out the perfect hash qleei.h looks builtin words up with, see QLEEI_BUILTIN_HASH.
+//
+// `builtin_hash check` fails if the table in qleei.h doesn't send every builtin word to its own slot anymore.
+// `builtin_hash write` searches the first seed that does and writes it, with its table, back into qleei.h.
+#define NOB_IMPLEMENTATION
+#define NOB_STRIP_PREFIX
+#include "../nob.h"
+
+#define QLEEI_IMPLEMENTATION
+#define PLATFORM_DESKTOP
+#include "../qleei.h"
+
+#define HEADER_PATH "./qleei.h"
+#define SLOTS_COUNT (sizeof(QLEEI_BUILTIN_HASH) / sizeof(QLEEI_BUILTIN_HASH[0]))
+#define SEED_LIMIT 1000000u
+
+#define SEED_LINE   "#define QLEEI_BUILTIN_HASH_SEED"
+#define TABLE_START "static const Qleei__Builtin_Slot QLEEI_BUILTIN_HASH[QLEEI_BUILTIN_HASH_SLOTS] = {\n"
+#define TABLE_END   "};\n"
+
+/**
+ * Check that every builtin word is found in its own slot of the table compiled in from qleei.h.
+ *
+ * @returns `true` if the table is up to date with QLEEI_BUILTIN_WORDS, `false` otherwise.
+ */
+bool table_is_current(void) {
+  size_t slots_used = 0;
+  for (size_t i = 0; i < SLOTS_COUNT; ++i) slots_used += QLEEI_BUILTIN_HASH[i].word != 0;
+  if (slots_used != QLEEI_BUILTIN_WORD_COUNT) return false;
+  for (size_t i = 0; i < QLEEI_BUILTIN_WORD_COUNT; ++i) {
+    qleei_uisz_t found;
+    if (!qleei__find_builtin_word(qleei_sv_from_zstr(QLEEI_BUILTIN_WORDS[i].key), &found) || found != i) return false;
+  }
+  return true;
+}
+
+/**
+ * Search the first seed that sends every builtin word to its own slot.
+ *
+ * @param slots Receives the index of the word in each slot plus one, 0 for empty slots.
+ * @param seed Receives the seed found.
+ * @returns `true` if a seed below SEED_LIMIT was found, `false` otherwise.
+ */
+bool search_seed(size_t slots[SLOTS_COUNT], unsigned int *seed) {
+  for (unsigned int s = 0; s < SEED_LIMIT; ++s) {
+    memset(slots, 0, SLOTS_COUNT*sizeof(slots[0]));
+    size_t i = 0;
+    for (; i < QLEEI_BUILTIN_WORD_COUNT; ++i) {
+      size_t slot = qleei__hash_sv(qleei_sv_from_zstr(QLEEI_BUILTIN_WORDS[i].key), s) % SLOTS_COUNT;
+      if (slots[slot] != 0) break;
+      slots[slot] = i + 1;
+    }
+    if (i == QLEEI_BUILTIN_WORD_COUNT) {
+      *seed = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Replace the seed and the table of qleei.h with the ones found by `search_seed`.
+ *
+ * @returns `true` if qleei.h was written, `false` if its table couldn't be located or the file couldn't be written.
+ */
+bool write_table(size_t slots[SLOTS_COUNT], unsigned int seed) {
+  bool result = true;
+  String_Builder header = {0};
+  String_Builder sb = {0};
+  if (!read_entire_file(HEADER_PATH, &header)) return_defer(false);
+  sb_append_null(&header);
+
+  char *seed_line = strstr(header.items, SEED_LINE);
+  char *table = seed_line ? strstr(seed_line, TABLE_START) : NULL;
+  char *table_end = table ? strstr(table, TABLE_END) : NULL;
+  char *seed_line_end = seed_line ? strchr(seed_line, '\n') : NULL;
+  if (table_end == NULL || seed_line_end == NULL) {
+    nob_log(ERROR, "Could not find QLEEI_BUILTIN_HASH in %s", HEADER_PATH);
+    return_defer(false);
+  }
+
+  sb_append_buf(&sb, header.items, seed_line - header.items);
+  sb_appendf(&sb, SEED_LINE"  %uu", seed);
+  sb_append_buf(&sb, seed_line_end, table - seed_line_end);
+  sb_append_cstr(&sb, TABLE_START);
+  for (size_t slot = 0; slot < SLOTS_COUNT; ++slot) {
+    if (slots[slot] == 0) continue;
+    const char *name = QLEEI_BUILTIN_WORDS[slots[slot] - 1].key;
+    sb_appendf(&sb, "  [%3zu] = { %2zu, %2zu }, // %s\n", slot, slots[slot], strlen(name), name);
+  }
+  sb_append_cstr(&sb, table_end);
+
+  if (!write_entire_file(HEADER_PATH, sb.items, sb.count)) return_defer(false);
+  nob_log(INFO, "Wrote seed %u and its table to %s", seed, HEADER_PATH);
+
+defer:
+  sb_free(header);
+  sb_free(sb);
+  return result;
+}
+
+int main(int argc, char **argv) {
+  const char *program_name = shift(argv, argc);
+  const char *mode = argc > 0 ? shift(argv, argc) : "";
+
+  if (strcmp(mode, "check") == 0) {
+    if (table_is_current()) return 0;
+    nob_log(ERROR, "QLEEI_BUILTIN_HASH is out of date with QLEEI_BUILTIN_WORDS, run `./nob builtin-hash` to write it again");
+    return 1;
+  }
+
+  if (strcmp(mode, "write") == 0) {
+    size_t slots[SLOTS_COUNT];
+    unsigned int seed;
+    if (!search_seed(slots, &seed)) {
+      nob_log(ERROR, "No seed below %u sends every builtin word to its own slot, the table needs more slots", SEED_LIMIT);
+      return 1;
+    }
+    return write_table(slots, seed) ? 0 : 1;
+  }
+
+  fprintf(stderr, "Usage: %s <check|write>\n", program_name);
+  return 1;
+}
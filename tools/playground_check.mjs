@@ -0,0 +1,86 @@
+// Runs every example through the playground's qleei.js and qleei.wasm under node and compares what it prints with the
+// native interpreter, so the translated WebAssembly modules and the documents get checked without a browser.
+//
+// Usage: node tools/playground_check.mjs <native-interpreter> [wasm-path]
+//
+// All examples run in one document, each one edits the previous one into itself, then runs once more unchanged and
+// once with a comment added at its end, which only relexes the tail of the document.
+// Examples named *.m32.ql use words only the native build registers and are skipped.
+
+import { spawnSync } from 'node:child_process';
+import { readFileSync, readdirSync } from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+
+const root = path.resolve(path.dirname(fileURLToPath(import.meta.url)), '..');
+const [native, wasm_path = path.join(root, 'playground', 'qleei.wasm')] = process.argv.slice(2);
+if (!native) {
+  console.error('Usage: node tools/playground_check.mjs <native-interpreter> [wasm-path]');
+  process.exit(1);
+}
+
+// Without these qleei.js quietly interprets everything, which is not what is being checked
+const required = ['qleei_wasm_program_new', 'qleei_wasm_program_from_document', 'qleei_document_new', 'qleei_document_edit'];
+const exported = WebAssembly.Module.exports(new WebAssembly.Module(readFileSync(wasm_path))).map((e) => e.name);
+const missing = required.filter((name) => !exported.includes(name));
+if (missing.length > 0) {
+  console.error(`[FAIL] ${wasm_path} doesn't export ${missing.join(', ')}, build it again`);
+  process.exit(1);
+}
+
+// qleei.js fetches its module next to the page, serve it from disk instead
+globalThis.fetch = async () => new Response(readFileSync(wasm_path), { headers: { 'Content-Type': 'application/wasm' } });
+
+// Whatever the playground logs goes away, except for falling back to the interpreter which means the module failed
+let fell_back = false;
+console.log = () => {};
+console.warn = (...args) => {
+  fell_back = true;
+  process.stderr.write('[WARN] ' + args.join(' ') + '\n');
+};
+
+// qleei.js is an ES module without a package.json saying so, load it from its source
+const source = readFileSync(path.join(root, 'playground', 'qleei.js'), 'utf8');
+const { load_interpreter } = await import('data:text/javascript,' + encodeURIComponent(source));
+const interpreter = await load_interpreter();
+
+let output = '';
+interpreter.set_output({ write: (message) => { output += message; } });
+
+// Pointers differ between the builds and errors name the file they happened in
+const normalize = (text, file_path) => text
+  .split('\n')
+  .filter((line) => !line.startsWith('0x'))
+  .join('\n')
+  .replaceAll(file_path, 'input.ql');
+
+const examples = path.join(root, 'examples');
+let failed = 0;
+for (const name of readdirSync(examples).sort()) {
+  if (!name.endsWith('.ql') || name.endsWith('.m32.ql')) continue;
+  const file_path = path.join('examples', name);
+
+  // The interpreter prints errors to stdout as well
+  const result = spawnSync(native, [file_path], { cwd: root, encoding: 'utf8' });
+  const expected = normalize(result.stdout, file_path);
+  const expected_ok = result.status == 0;
+
+  const code = readFileSync(path.join(examples, name), 'utf8');
+  const runs = { edited: code, unchanged: code, appended: code + '\n// appended\n' };
+  for (const [run, text] of Object.entries(runs)) {
+    output = '';
+    fell_back = false;
+    const ok = await interpreter.exec(text);
+    const actual = normalize(output, file_path);
+    if (fell_back || ok !== expected_ok || actual !== expected) {
+      failed += 1;
+      console.error(`[FAIL] ${name} (${run})${fell_back ? ', the module was interpreted instead' : ''}`);
+      if (ok !== expected_ok) console.error(`  finished ${ok} but the native interpreter finished ${expected_ok}`);
+      if (actual !== expected) console.error(`  expected:\n${expected}\n  got:\n${actual}`);
+    } else {
+      console.error(`[OK]   ${name} (${run})`);
+    }
+  }
+}
+
+process.exit(failed == 0 ? 0 : 1);